@@ -0,0 +1,170 @@
+// Benchmarks the bridge through its public C API, so the numbers match what
+// Go callers see minus the cgo crossing. Each measurement is printed as one
+// JSON object per line:
+//
+//   pedalboard_bench [--quick] [--filter <substring>] [--seconds <n>]
+//
+// ns_per_sample is per sample frame (all channels); realtime is how many
+// times faster than real time the processor ran.
+#include "pedalboard.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    bool quick = false;
+    std::string filter;
+    double seconds = 0.25; // Minimum measured time per configuration
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedSeconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Planar test signal with every channel in one block, as the library allocates it.
+struct Signal {
+    Signal(int numChannels, int numSamples)
+        : storage((size_t)numChannels * (size_t)numSamples), channels((size_t)numChannels) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            channels[(size_t)ch] = storage.data() + (size_t)ch * (size_t)numSamples;
+        }
+        fill();
+    }
+
+    // Low-level noise keeps dynamics processors and filters out of denormals
+    void fill() {
+        unsigned int seed = 12345;
+        for (auto& sample : storage) {
+            seed = seed * 1664525u + 1013904223u;
+            sample = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 0.5f;
+        }
+    }
+
+    std::vector<float> storage;
+    std::vector<float*> channels;
+};
+
+void benchProcessor(const Options& options, const char* name, int blockSize, int numChannels, double sampleRate) {
+    PedalboardProcessor processor = pedalboard_create_internal_processor(name);
+    if (processor == nullptr) return;
+    pedalboard_processor_prepare(processor, sampleRate, blockSize, numChannels);
+
+    Signal signal(numChannels, blockSize);
+
+    // Warm up caches and let smoothed parameters settle
+    for (int i = 0; i < 16; ++i) {
+        pedalboard_processor_process(processor, signal.channels.data(), numChannels, blockSize, sampleRate);
+    }
+
+    long long blocks = 0;
+    const auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        for (int i = 0; i < 64; ++i) {
+            pedalboard_processor_process(processor, signal.channels.data(), numChannels, blockSize, sampleRate);
+        }
+        blocks += 64;
+        elapsed = elapsedSeconds(start);
+    } while (elapsed < options.seconds);
+
+    const double samples = (double)blocks * blockSize;
+    std::printf("{\"bench\":\"processor\",\"name\":\"%s\",\"block_size\":%d,\"channels\":%d,\"sample_rate\":%.0f,"
+                "\"ns_per_block\":%.1f,\"ns_per_sample\":%.3f,\"realtime\":%.1f}\n",
+                name, blockSize, numChannels, sampleRate,
+                elapsed * 1.0e9 / (double)blocks,
+                elapsed * 1.0e9 / samples,
+                samples / sampleRate / elapsed);
+    std::fflush(stdout);
+
+    pedalboard_processor_free(processor);
+}
+
+void benchFileIO(const Options& options, const char* extension) {
+    const int numChannels = 2;
+    const int numSamples = 44100 * (options.quick ? 5 : 30);
+    const std::string path = std::string("pedalboard_bench_io.") + extension;
+
+    PedalboardAudioBuffer* buffer = pedalboard_audio_buffer_create(numChannels, numSamples, 44100.0);
+    if (buffer == nullptr) return;
+    Signal signal(numChannels, numSamples);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::memcpy(buffer->data[ch], signal.channels[(size_t)ch], sizeof(float) * (size_t)numSamples);
+    }
+
+    auto start = Clock::now();
+    pedalboard_save_audio_file(path.c_str(), buffer);
+    const double saveSeconds = elapsedSeconds(start);
+
+    start = Clock::now();
+    PedalboardAudioBuffer* loaded = pedalboard_load_audio_file(path.c_str());
+    const double loadSeconds = elapsedSeconds(start);
+
+    const double bytes = (double)numChannels * numSamples * sizeof(float);
+    std::printf("{\"bench\":\"file_save\",\"format\":\"%s\",\"channels\":%d,\"samples\":%d,\"seconds\":%.6f,\"mb_per_second\":%.1f}\n",
+                extension, numChannels, numSamples, saveSeconds, bytes / saveSeconds / 1.0e6);
+    if (loaded != nullptr) {
+        std::printf("{\"bench\":\"file_load\",\"format\":\"%s\",\"channels\":%d,\"samples\":%d,\"seconds\":%.6f,\"mb_per_second\":%.1f}\n",
+                    extension, numChannels, numSamples, loadSeconds, bytes / loadSeconds / 1.0e6);
+        pedalboard_audio_buffer_free(loaded);
+    }
+    std::fflush(stdout);
+
+    pedalboard_audio_buffer_free(buffer);
+    std::remove(path.c_str());
+}
+
+bool matches(const Options& options, const char* name) {
+    return options.filter.empty() || std::strstr(name, options.filter.c_str()) != nullptr;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+            options.seconds = 0.05;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            options.seconds = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--filter <substring>] [--seconds <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    pedalboard_init();
+
+    const std::vector<int> blockSizes = options.quick ? std::vector<int> { 64, 1024 }
+                                                      : std::vector<int> { 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+    const std::vector<int> channelCounts = options.quick ? std::vector<int> { 2 } : std::vector<int> { 1, 2, 8 };
+    const std::vector<double> sampleRates = options.quick ? std::vector<double> { 48000.0 }
+                                                          : std::vector<double> { 44100.0, 48000.0, 96000.0 };
+
+    for (int i = 0; i < pedalboard_get_num_internal_processors(); ++i) {
+        const char* name = pedalboard_get_internal_processor_name(i);
+        if (!matches(options, name)) continue;
+        for (double sampleRate : sampleRates) {
+            for (int numChannels : channelCounts) {
+                for (int blockSize : blockSizes) {
+                    benchProcessor(options, name, blockSize, numChannels, sampleRate);
+                }
+            }
+        }
+    }
+
+    for (const char* extension : { "wav", "aiff", "flac" }) {
+        if (matches(options, extension)) benchFileIO(options, extension);
+    }
+    return 0;
+}
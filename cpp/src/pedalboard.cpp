@@ -5,6 +5,12 @@
 #include <juce_events/juce_events.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
 
 extern "C" {
 
@@ -17,35 +23,852 @@ float mapRangeLog(float input, float min, float max) {
     return min * std::pow(max / min, input);
 }
 
+// 128-bit content hash for cache keys: two FNV-1a lanes with different
+// offset bases, the second also mixing in the byte position. Fast and
+// stable across runs, but not cryptographic.
+struct ContentHash {
+    juce::uint64 a = 14695981039346656037ull;
+    juce::uint64 b = 0x9e3779b97f4a7c15ull;
+    juce::uint64 length = 0;
+
+    void add(const void* data, size_t size) {
+        const auto* bytes = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            a = (a ^ bytes[i]) * 1099511628211ull;
+            b = (b ^ bytes[i] ^ (length++ << 8)) * 0x100000001b3ull;
+        }
+    }
+    void addInt(juce::int64 value) { add(&value, sizeof(value)); }
+    void addDouble(double value) { add(&value, sizeof(value)); }
+    void addString(const juce::String& text) { add(text.toRawUTF8(), text.getNumBytesAsUTF8() + 1); }
+    void addBlock(const juce::MemoryBlock& block) {
+        addInt((juce::int64)block.getSize());
+        add(block.getData(), block.getSize());
+    }
+
+    juce::String toString() const {
+        return juce::String::toHexString((juce::int64)a).paddedLeft('0', 16) + juce::String::toHexString((juce::int64)b).paddedLeft('0', 16);
+    }
+};
+
+struct ImpulseResponse;
+struct ConvolutionSpectra;
+
+// Library-wide state. Construction only creates the message manager, which
+// is cheap but makes the constructing thread the message thread, so it runs
+// on whichever thread calls pedalboard_init first. Audio formats and plugin
+// hosting set themselves up the first time they're used, so a binary that
+// only reads files never pays for plugin format registration.
 class PedalboardInternal {
 public:
-    PedalboardInternal() {
-        juce::MessageManager::getInstance();
-        formatManager.registerBasicFormats();
+    PedalboardInternal() { juce::MessageManager::getInstance(); }
+
+    // Thread-safe. Registers the basic audio formats on first use.
+    juce::AudioFormatManager& getFormatManager() {
+        std::call_once(formatsInitialised, [this] { formatManager.registerBasicFormats(); });
+        return formatManager;
+    }
+
+    // Thread-safe. Adds the plugin formats on first use.
+    juce::AudioPluginFormatManager& getPluginFormatManager() {
+        std::call_once(pluginsInitialised, [this] {
 #if JUCE_MAC
-        pluginFormatManager.addFormat(std::make_unique<juce::AudioUnitPluginFormat>());
+            pluginFormatManager.addFormat(std::make_unique<juce::AudioUnitPluginFormat>());
 #endif
-        pluginFormatManager.addFormat(std::make_unique<juce::VST3PluginFormat>());
+            pluginFormatManager.addFormat(std::make_unique<juce::VST3PluginFormat>());
+        });
+        return pluginFormatManager;
+    }
+
+    // Returns the plugin types in a file, scanning it only if it isn't in
+    // the cache or has been modified since it was scanned.
+    void findPluginTypes(const juce::String& path, juce::OwnedArray<juce::PluginDescription>& results) {
+        bool added = false;
+        auto& formats = getPluginFormatManager();
+        for (int i = 0; i < formats.getNumFormats(); ++i) {
+            auto* format = formats.getFormat(i);
+            if (!format->fileMightContainThisPluginType(path)) continue;
+            added = knownPlugins.scanAndAddFile(path, true, results, *format) || added;
+            if (results.size() > 0) break;
+        }
+        if (added) savePluginCache();
+    }
+
+    bool setPluginCacheFile(const juce::File& file) {
+        {
+            const juce::ScopedLock sl(pluginCacheLock);
+            pluginCacheFile = file;
+        }
+        if (!file.existsAsFile()) return true;
+
+        auto xml = juce::parseXML(file);
+        if (xml == nullptr) return false;
+        knownPlugins.recreateFromXml(*xml);
+        return true;
+    }
+
+    void savePluginCache() {
+        const juce::ScopedLock sl(pluginCacheLock);
+        if (pluginCacheFile == juce::File()) return;
+        if (auto xml = knownPlugins.createXml()) {
+            xml->writeTo(pluginCacheFile);
+        }
+    }
+
+    ~PedalboardInternal() {
+        writerThread.stopThread(2000);
+        graphThread.stopThread(2000);
     }
 
+    // Shared background thread for threaded file writers, started on first use.
+    juce::TimeSliceThread& getWriterThread() {
+        const juce::ScopedLock sl(writerThreadLock);
+        if (!writerThread.isThreadRunning()) writerThread.startThread();
+        return writerThread;
+    }
+
+    // Shared background thread where graphs rebuild after a latency change
+    // reported mid-block, started on first use.
+    juce::TimeSliceThread& getGraphThread() {
+        const juce::ScopedLock sl(writerThreadLock);
+        if (!graphThread.isThreadRunning()) graphThread.startThread();
+        return graphThread;
+    }
+
+    juce::KnownPluginList knownPlugins;
+    juce::File pluginCacheFile;
+    juce::CriticalSection pluginCacheLock;
+    juce::TimeSliceThread writerThread { "Pedalboard Writer" };
+    juce::TimeSliceThread graphThread { "Pedalboard Graph" };
+    juce::CriticalSection writerThreadLock; // Guards starting either background thread
+
+    // Impulse responses and their partitioned spectra, shared by every
+    // convolution processor using them. Entries expire with their last user.
+    std::map<juce::String, std::weak_ptr<const ImpulseResponse>> impulseResponses;
+    std::map<juce::String, std::weak_ptr<const ConvolutionSpectra>> convolutionSpectra;
+    juce::CriticalSection convolutionLock;
+
+private:
     juce::AudioFormatManager formatManager;
     juce::AudioPluginFormatManager pluginFormatManager;
+    std::once_flag formatsInitialised, pluginsInitialised;
 };
 
 static PedalboardInternal* g_internal = nullptr;
 
+// Thread-safe; every entry point that needs g_internal calls it. Call it
+// first from the thread that should own the message manager.
 void pedalboard_init() {
-    if (g_internal == nullptr) {
-        g_internal = new PedalboardInternal();
+    static std::once_flag created;
+    std::call_once(created, [] { g_internal = new PedalboardInternal(); });
+}
+
+// --- Instrumentation ---
+static void atomicMax(std::atomic<juce::int64>& target, juce::int64 value) {
+    auto current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+static juce::int64 ticksToNanoseconds(juce::int64 ticks) {
+    return (juce::int64)(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9);
+}
+
+// Lock-free process-time counters, written by whichever thread processes.
+struct ProcessStats {
+    std::atomic<juce::int64> calls { 0 };
+    std::atomic<juce::int64> totalTicks { 0 };
+    std::atomic<juce::int64> maxTicks { 0 };
+    std::atomic<juce::int64> bypassed { 0 }; // Silent blocks skipped by auto-bypass
+
+    void record(juce::int64 ticks) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        totalTicks.fetch_add(ticks, std::memory_order_relaxed);
+        atomicMax(maxTicks, ticks);
+    }
+
+    void reset() {
+        calls.store(0, std::memory_order_relaxed);
+        totalTicks.store(0, std::memory_order_relaxed);
+        maxTicks.store(0, std::memory_order_relaxed);
+        bypassed.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Times a scope into a ProcessStats.
+struct ScopedProcessTimer {
+    explicit ScopedProcessTimer(ProcessStats& s) : stats(s), start(juce::Time::getHighResolutionTicks()) {}
+    ~ScopedProcessTimer() { stats.record(juce::Time::getHighResolutionTicks() - start); }
+
+    ProcessStats& stats;
+    const juce::int64 start;
+};
+
+// --- Silence Detection ---
+// Peak level below which a block counts as digital silence (-100 dBFS).
+// Internal processors report their tail as the time to decay to this level.
+static constexpr float silenceThreshold = 1.0e-5f;
+
+static bool isSilent(const juce::AudioBuffer<float>& buffer) {
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch), buffer.getNumSamples());
+        if (range.getStart() < -silenceThreshold || range.getEnd() > silenceThreshold) return false;
+    }
+    return true;
+}
+
+// Tracks how long a processor has been fed silence. Once its latency and
+// tail have passed its output is silent too, so the block can be skipped and
+// the silent input left in place. Because the processor only stops after it
+// has fully decayed, resuming on the next non-silent block is seamless.
+// Touched only by the thread that processes the wrapper.
+struct SilenceGate {
+    juce::int64 silentSamples = 0;
+
+    bool shouldBypass(juce::AudioProcessor& processor, const juce::AudioBuffer<float>& buffer) {
+        if (!isSilent(buffer)) {
+            silentSamples = 0;
+            return false;
+        }
+
+        // Instruments make sound from silence; an infinite tail never decays
+        const double tail = processor.getTailLengthSeconds();
+        if (processor.acceptsMidi() || !std::isfinite(tail)) return false;
+
+        const auto decaySamples = (juce::int64)std::ceil(tail * processor.getSampleRate()) + processor.getLatencySamples();
+        const bool bypass = silentSamples >= decaySamples;
+        silentSamples += buffer.getNumSamples();
+        return bypass;
+    }
+};
+
+// --- Analysis ---
+// Sum of squares in double. Eight independent float partial sums let the
+// compiler vectorise the inner loop without reassociating one accumulator;
+// each chunk's partials are folded into the double total.
+static double sumOfSquares(const float* data, int numSamples) {
+    double total = 0.0;
+    int i = 0;
+    while (numSamples - i >= 8) {
+        float partial[8] = {};
+        const int end = i + juce::jmin(numSamples - i, 4096) / 8 * 8;
+        for (; i < end; i += 8) {
+            for (int j = 0; j < 8; ++j) partial[j] += data[i + j] * data[i + j];
+        }
+        for (float sum : partial) total += sum;
     }
+    for (; i < numSamples; ++i) total += (double)data[i] * data[i];
+    return total;
 }
 
+// Level, loudness and spectrum measurements accumulated block by block, so
+// they are a side effect of the processing pass rather than a second pass
+// over the rendered audio. Loudness follows ITU-R BS.1770-4 and EBU R128:
+// K-weighted mean square over 400 ms blocks every 100 ms, with integrated
+// loudness gated at -70 LUFS and 10 LU below the ungated level. The gated
+// blocks go into a fixed 0.1 LU histogram, as in libebur128, so memory stays
+// constant however long the analysis runs. True peak is the sample peak of
+// the signal oversampled 4x through linear-phase FIR half-band filters,
+// whose delay holds back the last few samples' peaks until more input
+// arrives. The spectrum is the average power of
+// Hann-windowed, non-overlapping FFT frames of the channel mix.
+// One thread processes without locking or allocating; any number of others
+// read results, retrying if a read overlaps the processing thread
+// publishing. Levels cover the channels actually passed.
+class Analyzer {
+public:
+    Analyzer(double rate, int channels, int spectrumSize)
+        : sampleRate(rate), numChannels(channels),
+          // BS.1770-4 Annex 2 interpolates with a linear-phase FIR; an IIR's
+          // phase distortion would misplace the peaks between samples
+          oversampling((size_t)channels, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true) {
+        oversampling.initProcessing((size_t)maxChunkSize);
+        weighted.setSize(numChannels, maxChunkSize);
+        segmentLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+        segmentEnergies.resize((size_t)numChannels);
+
+        // BS.1770 channel weights for 5.0 and 5.1 (L R C [LFE] Ls Rs); others weigh 1
+        channelWeights.assign((size_t)numChannels, 1.0);
+        if (numChannels == 5) channelWeights[3] = channelWeights[4] = 1.41;
+        if (numChannels == 6) {
+            channelWeights[3] = 0.0;
+            channelWeights[4] = channelWeights[5] = 1.41;
+        }
+
+        const auto shelf = makeKWeightingShelf(sampleRate);
+        const auto highPass = makeKWeightingHighPass(sampleRate);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            shelfFilters.emplace_back(shelf);
+            highPassFilters.emplace_back(highPass);
+        }
+
+        if (spectrumSize > 0) {
+            const int order = juce::jlimit(4, 16, (int)std::ceil(std::log2((double)spectrumSize)));
+            fft = std::make_unique<juce::dsp::FFT>(order);
+            window = std::make_unique<juce::dsp::WindowingFunction<float>>((size_t)fft->getSize(), juce::dsp::WindowingFunction<float>::hann, false);
+            frame.resize((size_t)fft->getSize() * 2);
+            frameInput.resize((size_t)fft->getSize());
+            numBins = fft->getSize() / 2 + 1;
+            powerSums.reset(new std::atomic<double>[(size_t)numBins]);
+        }
+        clear();
+        publish();
+    }
+
+    // Thread-safe. Results read as empty at once; the processing thread
+    // clears its state at the start of its next call.
+    void reset() { ++resetsRequested; }
+
+    // Channels beyond the analyzer's are ignored.
+    void process(const float* const* samples, int channels, int count) {
+        const auto requested = resetsRequested.load();
+        if (requested != resetsApplied.load(std::memory_order_relaxed)) {
+            clear();
+            publish();
+            resetsApplied.store(requested);
+        }
+
+        channels = juce::jmin(channels, numChannels);
+        if (channels <= 0) return;
+        for (int start = 0; start < count; start += maxChunkSize) {
+            const int chunk = juce::jmin(maxChunkSize, count - start);
+            processChunk(samples, channels, start, chunk);
+        }
+        publish();
+    }
+
+    void getResults(PedalboardAnalysis& results) const {
+        const float silence = -std::numeric_limits<float>::infinity();
+        if (isResetPending()) {
+            results = {};
+            results.momentary_lufs = results.short_term_lufs = results.integrated_lufs = silence;
+            return;
+        }
+
+        for (;;) {
+            const auto before = beginRead();
+            results.num_samples = published.numSamples.load(std::memory_order_relaxed);
+            results.peak = published.peak.load(std::memory_order_relaxed);
+            results.true_peak = published.truePeak.load(std::memory_order_relaxed);
+            results.rms = published.rms.load(std::memory_order_relaxed);
+            results.momentary_lufs = published.momentary.load(std::memory_order_relaxed);
+            results.short_term_lufs = published.shortTerm.load(std::memory_order_relaxed);
+            results.integrated_lufs = published.integrated.load(std::memory_order_relaxed);
+            if (endRead(before)) return;
+        }
+    }
+
+    // Average power per bin in dB relative to a full-scale sine. Returns the
+    // number of bins (fftSize / 2 + 1), writing at most maxBins.
+    int getSpectrum(float* decibels, int maxBins) const {
+        if (fft == nullptr) return 0;
+        if (decibels == nullptr) return numBins;
+
+        // A full-scale sine peaks at a Hann-windowed magnitude of N/4
+        const double reference = std::pow(fft->getSize() / 4.0, 2.0);
+        const bool resetPending = isResetPending();
+        for (;;) {
+            const auto before = beginRead();
+            const auto frames = resetPending ? 0 : published.numFrames.load(std::memory_order_relaxed);
+            for (int bin = 0; bin < juce::jmin(numBins, maxBins); ++bin) {
+                const double power = frames > 0 ? powerSums[(size_t)bin].load(std::memory_order_relaxed) / (double)frames / reference : 0.0;
+                decibels[bin] = power > 1.0e-20 ? (float)(10.0 * std::log10(power)) : -200.0f;
+            }
+            if (endRead(before)) return numBins;
+        }
+    }
+
+private:
+    static constexpr int maxChunkSize = 1024;
+    static constexpr int shortTermSegments = 30; // 3 s
+    static constexpr int blockSegments = 4;      // 400 ms
+    static constexpr double gatingFloor = -70.0; // LUFS, the absolute gate
+    static constexpr double gatingStep = 0.1;    // LU per histogram bin
+    static constexpr int gatingBins = 1000;      // -70 to +30 LUFS; louder blocks share the top bin
+
+    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+    // The BS.1770 pre-filter and RLB high-pass, designed for any rate from
+    // the analogue prototypes of the published 48 kHz coefficients.
+    static Coefficients::Ptr makeKWeightingShelf(double rate) {
+        const double k = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / rate);
+        const double q = 0.7071752369554196;
+        const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        return new Coefficients((float)(vh + vb * k / q + k * k), (float)(2.0 * (k * k - vh)), (float)(vh - vb * k / q + k * k),
+                                (float)(1.0 + k / q + k * k), (float)(2.0 * (k * k - 1.0)), (float)(1.0 - k / q + k * k));
+    }
+
+    static Coefficients::Ptr makeKWeightingHighPass(double rate) {
+        const double k = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / rate);
+        const double q = 0.5003270373238773;
+        return new Coefficients(1.0f, -2.0f, 1.0f,
+                                (float)(1.0 + k / q + k * k), (float)(2.0 * (k * k - 1.0)), (float)(1.0 - k / q + k * k));
+    }
+
+    static double toLoudness(double energy) { return -0.691 + 10.0 * std::log10(energy); }
+
+    static float toLUFS(double energy) {
+        return energy > 0.0 ? (float)toLoudness(energy) : -std::numeric_limits<float>::infinity();
+    }
+
+    // Processing thread only
+    void clear() {
+        oversampling.reset();
+        for (auto& filter : shelfFilters) filter.reset();
+        for (auto& filter : highPassFilters) filter.reset();
+        numSamples = 0;
+        numChannelSamples = 0;
+        peak = truePeak = 0.0f;
+        sumSquares = 0.0;
+        std::fill(segmentEnergies.begin(), segmentEnergies.end(), 0.0);
+        segmentPosition = 0;
+        std::fill(std::begin(recentSegments), std::end(recentSegments), 0.0);
+        numSegments = publishedSegments = 0;
+        momentaryEnergy = 0.0;
+        integratedLUFS = -std::numeric_limits<float>::infinity();
+        std::fill(std::begin(gatingEnergy), std::end(gatingEnergy), 0.0);
+        std::fill(std::begin(gatingCount), std::end(gatingCount), (juce::int64)0);
+        std::fill(frameInput.begin(), frameInput.end(), 0.0f);
+        framePosition = 0;
+        numFrames = 0;
+
+        beginWrite();
+        for (int bin = 0; bin < numBins; ++bin) powerSums[(size_t)bin].store(0.0, std::memory_order_relaxed);
+        published.numFrames.store(0, std::memory_order_relaxed);
+        endWrite();
+    }
+
+    // Copies the processing thread's totals to where readers see them
+    void publish() {
+        if (numSegments != publishedSegments) {
+            integratedLUFS = getIntegratedLUFS();
+            publishedSegments = numSegments;
+        }
+
+        beginWrite();
+        published.numSamples.store(numSamples, std::memory_order_relaxed);
+        published.peak.store(peak, std::memory_order_relaxed);
+        published.truePeak.store(juce::jmax(peak, truePeak), std::memory_order_relaxed);
+        published.rms.store(numChannelSamples > 0 ? (float)std::sqrt(sumSquares / (double)numChannelSamples) : 0.0f, std::memory_order_relaxed);
+        published.momentary.store(numSegments >= blockSegments ? toLUFS(momentaryEnergy) : -std::numeric_limits<float>::infinity(), std::memory_order_relaxed);
+        published.shortTerm.store(getShortTermLUFS(), std::memory_order_relaxed);
+        published.integrated.store(integratedLUFS, std::memory_order_relaxed);
+        endWrite();
+    }
+
+    // A sequence lock over atomics: the count is odd while the processing
+    // thread writes, and a reader that saw it odd or changed reads again.
+    void beginWrite() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite() { sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    juce::uint32 beginRead() const {
+        for (;;) {
+            const auto count = sequence.load(std::memory_order_acquire);
+            if ((count & 1u) == 0) return count;
+            std::this_thread::yield();
+        }
+    }
+
+    bool endRead(juce::uint32 before) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    bool isResetPending() const { return resetsRequested.load() != resetsApplied.load(); }
+
+    void processChunk(const float* const* samples, int channels, int start, int count) {
+        for (int ch = 0; ch < channels; ++ch) {
+            const float* data = samples[ch] + start;
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data, count);
+            peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+            sumSquares += sumOfSquares(data, count);
+            weighted.copyFrom(ch, 0, data, count);
+        }
+        numSamples += count;
+        numChannelSamples += (juce::int64)count * channels;
+
+        // The oversampler runs every channel it was built for; only the ones
+        // passed in hold this chunk
+        juce::dsp::AudioBlock<const float> input(samples, (size_t)channels, (size_t)start, (size_t)count);
+        const auto upsampled = oversampling.processSamplesUp(input);
+        for (size_t ch = 0; ch < (size_t)channels; ++ch) {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(upsampled.getChannelPointer(ch), (int)upsampled.getNumSamples());
+            truePeak = juce::jmax(truePeak, -range.getStart(), range.getEnd());
+        }
+
+        accumulateLoudness(channels, count);
+        if (fft != nullptr) accumulateSpectrum(samples, channels, start, count);
+    }
+
+    void accumulateLoudness(int channels, int count) {
+        juce::dsp::AudioBlock<float> block(weighted);
+        for (int ch = 0; ch < channels; ++ch) {
+            auto channel = block.getSingleChannelBlock((size_t)ch).getSubBlock(0, (size_t)count);
+            shelfFilters[(size_t)ch].process(juce::dsp::ProcessContextReplacing<float>(channel));
+            highPassFilters[(size_t)ch].process(juce::dsp::ProcessContextReplacing<float>(channel));
+        }
+
+        for (int done = 0; done < count;) {
+            const int length = juce::jmin(segmentLength - segmentPosition, count - done);
+            for (int ch = 0; ch < channels; ++ch) {
+                segmentEnergies[(size_t)ch] += sumOfSquares(weighted.getReadPointer(ch, done), length);
+            }
+            segmentPosition += length;
+            done += length;
+            if (segmentPosition == segmentLength) finishSegment();
+        }
+    }
+
+    // Every 100 ms: record the segment's weighted energy, and once 400 ms
+    // have passed, the energy of the block ending here
+    void finishSegment() {
+        double energy = 0.0;
+        for (size_t ch = 0; ch < segmentEnergies.size(); ++ch) {
+            energy += channelWeights[ch] * segmentEnergies[ch] / segmentLength;
+            segmentEnergies[ch] = 0.0;
+        }
+        segmentPosition = 0;
+        recentSegments[numSegments % shortTermSegments] = energy;
+        ++numSegments;
+
+        if (numSegments >= blockSegments) {
+            double block = 0.0;
+            for (int i = 1; i <= blockSegments; ++i) block += recentSegments[(numSegments - i) % shortTermSegments];
+            momentaryEnergy = block / blockSegments;
+            addGatingBlock(momentaryEnergy);
+        }
+    }
+
+    // Blocks under the absolute gate never count, so they aren't kept
+    void addGatingBlock(double energy) {
+        if (energy <= 0.0) return;
+        const double loudness = toLoudness(energy);
+        if (loudness <= gatingFloor) return;
+        const int bin = juce::jmin(gatingBins - 1, (int)((loudness - gatingFloor) / gatingStep));
+        gatingEnergy[bin] += energy;
+        ++gatingCount[bin];
+    }
+
+    float getShortTermLUFS() const {
+        const int count = (int)juce::jmin((juce::int64)shortTermSegments, numSegments);
+        if (count == 0) return -std::numeric_limits<float>::infinity();
+        double energy = 0.0;
+        for (int i = 0; i < count; ++i) energy += recentSegments[i];
+        return toLUFS(energy / count);
+    }
+
+    // The relative gate falls on a bin boundary, so blocks within 0.1 LU
+    // below it may count too
+    float getIntegratedLUFS() const {
+        auto gatedMean = [this](int firstBin) {
+            double sum = 0.0;
+            juce::int64 count = 0;
+            for (int bin = firstBin; bin < gatingBins; ++bin) {
+                sum += gatingEnergy[bin];
+                count += gatingCount[bin];
+            }
+            return count > 0 ? sum / (double)count : 0.0;
+        };
+
+        const double ungated = gatedMean(0);
+        if (ungated <= 0.0) return -std::numeric_limits<float>::infinity();
+        const double relativeGate = toLoudness(ungated) - 10.0;
+        return toLUFS(gatedMean(juce::jlimit(0, gatingBins - 1, (int)((relativeGate - gatingFloor) / gatingStep))));
+    }
+
+    void accumulateSpectrum(const float* const* samples, int channels, int start, int count) {
+        const int size = fft->getSize();
+        const float channelGain = 1.0f / (float)channels;
+        for (int done = 0; done < count;) {
+            const int length = juce::jmin(size - framePosition, count - done);
+            for (int ch = 0; ch < channels; ++ch) {
+                juce::FloatVectorOperations::addWithMultiply(frameInput.data() + framePosition, samples[ch] + start + done, channelGain, length);
+            }
+            framePosition += length;
+            done += length;
+
+            if (framePosition == size) {
+                std::copy(frameInput.begin(), frameInput.end(), frame.begin());
+                window->multiplyWithWindowingTable(frame.data(), (size_t)size);
+                fft->performFrequencyOnlyForwardTransform(frame.data(), true);
+
+                // Only this thread writes the sums, so each is a load and a store
+                beginWrite();
+                for (int bin = 0; bin < numBins; ++bin) {
+                    auto& sum = powerSums[(size_t)bin];
+                    sum.store(sum.load(std::memory_order_relaxed) + (double)frame[(size_t)bin] * frame[(size_t)bin], std::memory_order_relaxed);
+                }
+                published.numFrames.store(++numFrames, std::memory_order_relaxed);
+                endWrite();
+
+                std::fill(frameInput.begin(), frameInput.end(), 0.0f);
+                framePosition = 0;
+            }
+        }
+    }
+
+    const double sampleRate;
+    const int numChannels;
+
+    // Processing thread only
+    juce::int64 numSamples = 0;
+    juce::int64 numChannelSamples = 0; // Samples times the channels passed with them, for RMS
+    float peak = 0.0f, truePeak = 0.0f;
+    double sumSquares = 0.0;
+    juce::dsp::Oversampling<float> oversampling;
+
+    std::vector<juce::dsp::IIR::Filter<float>> shelfFilters, highPassFilters;
+    std::vector<double> channelWeights;
+    juce::AudioBuffer<float> weighted; // K-weighted copy of the current chunk
+    int segmentLength = 0;
+    int segmentPosition = 0;
+    std::vector<double> segmentEnergies; // Per channel, in the current 100 ms segment
+    double recentSegments[shortTermSegments] {};
+    juce::int64 numSegments = 0;
+    juce::int64 publishedSegments = 0;
+    double momentaryEnergy = 0.0;
+    float integratedLUFS = 0.0f;
+    double gatingEnergy[gatingBins] {};    // Sum of the 400 ms block energies in each bin
+    juce::int64 gatingCount[gatingBins] {}; // And how many there were
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    std::vector<float> frame, frameInput;
+    int framePosition = 0;
+    juce::int64 numFrames = 0;
+    int numBins = 0;
+
+    // What readers see, written only by the processing thread
+    struct Published {
+        std::atomic<juce::int64> numSamples { 0 };
+        std::atomic<float> peak { 0.0f }, truePeak { 0.0f }, rms { 0.0f };
+        std::atomic<float> momentary { 0.0f }, shortTerm { 0.0f }, integrated { 0.0f };
+        std::atomic<juce::int64> numFrames { 0 };
+    };
+    Published published;
+    std::unique_ptr<std::atomic<double>[]> powerSums; // Per bin, summed over every frame
+    std::atomic<juce::uint32> sequence { 0 };
+    std::atomic<juce::uint32> resetsRequested { 0 }, resetsApplied { 0 };
+};
+
+// --- Audio Taps ---
+// A single-producer, single-consumer ring of planar audio, for getting audio
+// off a real-time thread. Pushing never locks or allocates: when the ring is
+// full the excess is dropped and counted, so a slow consumer can't cause an
+// xrun. The consumer drains it in large batches from one other thread.
+class AudioTap {
+public:
+    AudioTap(int channels, int capacity) : numChannels(channels), fifo(capacity + 1), storage(channels, capacity + 1) {
+        storage.clear();
+    }
+
+    // Channels beyond the tap's are ignored; missing ones are written as silence.
+    void push(const float* const* samples, int channels, int count) {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(count, start1, size1, start2, size2);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* source = ch < channels ? samples[ch] : nullptr;
+            copyIn(ch, start1, source, size1);
+            copyIn(ch, start2, source != nullptr ? source + size1 : nullptr, size2);
+        }
+        fifo.finishedWrite(size1 + size2);
+
+        const int numDropped = count - (size1 + size2);
+        if (numDropped > 0) dropped.fetch_add(numDropped, std::memory_order_relaxed);
+    }
+
+    // Moves up to maxCount samples per channel into destination and returns
+    // how many were moved.
+    int pull(float* const* destination, int channels, int maxCount) {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxCount, start1, size1, start2, size2);
+        for (int ch = 0; ch < juce::jmin(channels, numChannels); ++ch) {
+            juce::FloatVectorOperations::copy(destination[ch], storage.getReadPointer(ch, start1), size1);
+            juce::FloatVectorOperations::copy(destination[ch] + size1, storage.getReadPointer(ch, start2), size2);
+        }
+        for (int ch = numChannels; ch < channels; ++ch) {
+            juce::FloatVectorOperations::clear(destination[ch], size1 + size2);
+        }
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    int getNumReady() const { return fifo.getNumReady(); }
+    juce::int64 getNumDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    void copyIn(int ch, int start, const float* source, int count) {
+        if (count <= 0) return;
+        if (source != nullptr) juce::FloatVectorOperations::copy(storage.getWritePointer(ch, start), source, count);
+        else juce::FloatVectorOperations::clear(storage.getWritePointer(ch, start), count);
+    }
+
+    const int numChannels;
+    juce::AbstractFifo fifo;
+    juce::AudioBuffer<float> storage;
+    std::atomic<juce::int64> dropped { 0 };
+};
+
+// Lets a control thread swap a pointer the audio thread reads and then free
+// the old target. The audio thread holds a Scope while it uses anything it
+// loaded; after storing the replacement, the control thread waits for blocks
+// already in flight. Both sides are sequentially consistent, so once the
+// wait sees no block in progress, every later block loads the new pointer.
+struct AudioThreadGuard {
+    struct Scope {
+        explicit Scope(const AudioThreadGuard& g) : guard(g) { ++guard.inUse; }
+        ~Scope() { --guard.inUse; }
+        const AudioThreadGuard& guard;
+    };
+
+    void waitForAudioThread() const {
+        while (inUse.load() != 0) std::this_thread::yield();
+    }
+
+private:
+    mutable std::atomic<int> inUse { 0 };
+};
+
+// Where the audio thread finds an analyzer or tap it uses but doesn't own.
+// Detaching waits for an in-flight block to finish with the old one, so it
+// can be freed as soon as the setter returns.
+struct ObserverSlots {
+    std::atomic<Analyzer*> analyzer { nullptr };
+    std::atomic<AudioTap*> tap { nullptr };
+
+    // Audio thread
+    void observe(const float* const* samples, int channels, int count) {
+        const AudioThreadGuard::Scope scope(guard);
+        if (auto* target = analyzer.load()) target->process(samples, channels, count);
+        if (auto* target = tap.load()) target->push(samples, channels, count);
+    }
+
+    void setAnalyzer(Analyzer* target) {
+        analyzer.store(target);
+        guard.waitForAudioThread();
+    }
+
+    void setTap(AudioTap* target) {
+        tap.store(target);
+        guard.waitForAudioThread();
+    }
+
+private:
+    AudioThreadGuard guard;
+};
+
+// Nesting depth of ProcessorWrapper::processBlock on this thread. Non-zero
+// means the thread is processing audio, so a callback arriving on it (such
+// as a latency change) must not lock or allocate.
+static thread_local int processingDepth = 0;
+
 struct ProcessorWrapper {
+    // Recorded once at creation, so hot calls can static_cast instead of
+    // using dynamic_cast to find the processor's interface
+    enum class Kind { other, internal, fused };
+
     std::unique_ptr<juce::AudioProcessor> processor;
+    Kind kind = Kind::other;
     juce::AudioBuffer<float> buffer;
     juce::MidiBuffer midiBuffer;
+    std::unique_ptr<juce::PluginDescription> pluginDescription; // Set for hosted plugins
+    ProcessStats stats;
+    SilenceGate silenceGate;
+    int rejectedChannels = 0; // Channel count the processor refused, so it isn't retried every call
+    ObserverSlots observers; // Analyzer and tap on the output; not owned
+
+    // Every processBlock call on a wrapped processor goes through here, so
+    // its time is recorded wherever it runs (directly, in a chain or graph,
+    // or on a stream).
+    void processBlock(juce::AudioBuffer<float>& audio) {
+        ++processingDepth;
+        {
+            ScopedProcessTimer timer(stats);
+            processor->processBlock(audio, midiBuffer);
+        }
+        --processingDepth;
+        analyze(audio);
+    }
+
+    // Like processBlock, but skips silent blocks once the processor's tail
+    // has decayed. Bypassed blocks are counted but not timed.
+    void processBlockOrBypass(juce::AudioBuffer<float>& audio) {
+        if (silenceGate.shouldBypass(*processor, audio)) {
+            stats.bypassed.fetch_add(1, std::memory_order_relaxed);
+            analyze(audio);
+            return;
+        }
+        processBlock(audio);
+    }
+
+    void analyze(const juce::AudioBuffer<float>& audio) {
+        observers.observe(audio.getArrayOfReadPointers(), audio.getNumChannels(), audio.getNumSamples());
+    }
 };
 
+// Requests a symmetric layout of numChannels in and out. Returns false if the
+// processor rejects it, in which case its current layout is kept.
+static bool setChannelLayout(juce::AudioProcessor& processor, int numChannels) {
+    if (numChannels <= 0) return true;
+    if (processor.getTotalNumInputChannels() == numChannels && processor.getTotalNumOutputChannels() == numChannels) return true;
+
+    const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    return processor.setBusesLayout(layout);
+}
+
+// Mirrors what a host does: publish the layout, rate and block size before
+// preparing, so getSampleRate() and getBlockSize() reflect the prepared state.
+// numChannels of 0 keeps the processor's current layout.
+static bool prepareProcessor(juce::AudioProcessor& processor, double sampleRate, int samplesPerBlock, int numChannels = 0) {
+    const bool layoutApplied = setChannelLayout(processor, numChannels);
+    processor.setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
+    processor.prepareToPlay(sampleRate, samplesPerBlock);
+    return layoutApplied;
+}
+
+// Prepares the wrapped processor if this call's rate or channel count needs it.
+static void prepareForCall(ProcessorWrapper* wrapper, int num_channels, int num_samples, double sample_rate) {
+    auto& processor = *wrapper->processor;
+
+    // Unprepared, or the rate changed: prepare for this call's size
+    if (processor.getSampleRate() != sample_rate || processor.getBlockSize() <= 0) {
+        prepareProcessor(processor, sample_rate, num_samples);
+    }
+
+    // More channels than the layout: widen it, keeping the prepared block size
+    if (num_channels > processor.getTotalNumOutputChannels() && num_channels != wrapper->rejectedChannels) {
+        if (!prepareProcessor(processor, sample_rate, processor.getBlockSize(), num_channels)) {
+            wrapper->rejectedChannels = num_channels;
+        }
+    }
+}
+
+// Processes samples [start, end) in blocks no longer than the prepared size.
+// The wrapper's buffer only refers to the caller's memory, so this does not allocate.
+static void processSpan(ProcessorWrapper* wrapper, float* const* samples, int num_channels, int start, int end) {
+    const int maxBlockSize = wrapper->processor->getBlockSize();
+    for (; start < end; start += maxBlockSize) {
+        const int blockSize = juce::jmin(maxBlockSize, end - start);
+        wrapper->buffer.setDataToReferTo(const_cast<float**>(samples), num_channels, start, blockSize);
+        wrapper->midiBuffer.clear();
+        wrapper->processBlock(wrapper->buffer);
+    }
+}
+
+// Runs samples through the wrapped processor in-place. Calls longer than the
+// prepared block size are split into blocks the processor can take.
+static void processWrapper(ProcessorWrapper* wrapper, float* const* samples, int num_channels, int num_samples, double sample_rate) {
+    prepareForCall(wrapper, num_channels, num_samples, sample_rate);
+    processSpan(wrapper, samples, num_channels, 0, num_samples);
+}
+
 // --- Base Processor Class ---
 class BaseInternalProcessor : public juce::AudioProcessor {
 public:
@@ -57,6 +880,9 @@ public:
     ~BaseInternalProcessor() override = default;
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        // Apply queued values first so smoothed parameters start at their targets
+        applyPendingParams();
+
         juce::dsp::ProcessSpec spec;
         spec.sampleRate = sampleRate;
         spec.maximumBlockSize = (uint32_t)samplesPerBlock;
@@ -70,6 +896,8 @@ public:
     virtual void reset() {}
 
     const juce::String getName() const override { return procName; }
+    // Processors with memory override this with the time their output takes
+    // to fall below silenceThreshold once the input goes silent
     double getTailLengthSeconds() const override { return 0.0; }
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
@@ -79,17 +907,106 @@ public:
     void setCurrentProgram(int) override {}
     const juce::String getProgramName(int) override { return {}; }
     void changeProgramName(int, const juce::String&) override {}
-    void getStateInformation(juce::MemoryBlock&) override {}
-    void setStateInformation(const void*, int) override {}
+
+    // Any symmetric layout: every internal processor keeps per-channel state
+    // sized from the prepared channel count, so one instance can process a
+    // whole multitrack
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override {
+        const auto& channelSet = layouts.getMainOutputChannelSet();
+        return !channelSet.isDisabled() && layouts.getMainInputChannelSet() == channelSet;
+    }
+
+    // State is the processor name followed by every parameter value
+    void getStateInformation(juce::MemoryBlock& destData) override {
+        juce::MemoryOutputStream stream(destData, false);
+        stream.writeString(getName());
+        stream.writeInt(getNumParams());
+        for (int i = 0; i < getNumParams(); ++i) {
+            stream.writeFloat(getQueuedParam(i));
+        }
+    }
+
+    void setStateInformation(const void* data, int sizeInBytes) override {
+        juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+        if (stream.readString() != getName()) return;
+        const int numParams = stream.readInt();
+        for (int i = 0; i < numParams && !stream.isExhausted(); ++i) {
+            queueParam(i, stream.readFloat());
+        }
+    }
+
     juce::AudioProcessorEditor* createEditor() override { return nullptr; }
     bool hasEditor() const override { return false; }
 
+    // Parameter changes may come from any thread while the audio thread is
+    // processing. They are stored in atomic slots and applied by the audio
+    // thread at the start of the next block, so setParam() and the
+    // coefficient updates it triggers only ever run on the processing thread.
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) final {
+        applyPendingParams();
+        processAudio(buffer);
+    }
+
+    virtual void processAudio(juce::AudioBuffer<float>& buffer) = 0;
+
+    static constexpr int maxParams = 32;
+
+    // Thread-safe, lock-free. Takes effect at the start of the next block.
+    void queueParam(int index, float value) {
+        if (index < 0 || index >= juce::jmin(getNumParams(), maxParams)) return;
+        paramSlots[(size_t)index].store(value, std::memory_order_relaxed);
+        pendingParams.fetch_or(1u << index, std::memory_order_release);
+        paramQueued(index, value);
+    }
+
+    // Runs on the thread that queued the value, never the audio thread, for
+    // side effects setParam() must not have (such as reporting latency,
+    // which notifies listeners synchronously).
+    virtual void paramQueued(int index, float value) {}
+
+    // Thread-safe. Returns the most recently queued value.
+    float getQueuedParam(int index) const {
+        if (index < 0 || index >= maxParams) return 0.0f;
+        return paramSlots[(size_t)index].load(std::memory_order_relaxed);
+    }
+
+    // Seeds the slots from the processor's defaults; call once after construction.
+    void syncParamSlots() {
+        for (int i = 0; i < juce::jmin(getNumParams(), maxParams); ++i) {
+            paramSlots[(size_t)i].store(getParam(i), std::memory_order_relaxed);
+        }
+    }
+
+    void applyPendingParams() {
+        auto pending = pendingParams.exchange(0, std::memory_order_acquire);
+        for (int i = 0; pending != 0; ++i, pending >>= 1) {
+            if (pending & 1u) setParam(i, paramSlots[(size_t)i].load(std::memory_order_relaxed));
+        }
+    }
+
     virtual void setParam(int index, float value) = 0;
     virtual float getParam(int index) = 0;
     virtual int getNumParams() = 0;
 
+protected:
+    // Time for an exponential decay with the given time constant to reach silenceThreshold
+    static double decaySeconds(double timeConstantSeconds) {
+        return timeConstantSeconds * -std::log((double)silenceThreshold);
+    }
+
+    // Tail of a feedback loop: one pass, plus the passes needed for the loop
+    // gain to bring it down to silenceThreshold. A loop gain of 1 never decays.
+    static double feedbackTailSeconds(double loopSeconds, double loopGain) {
+        loopGain = std::abs(loopGain);
+        if (loopGain >= 1.0) return std::numeric_limits<double>::infinity();
+        if (loopGain <= 0.0) return loopSeconds;
+        return loopSeconds * (1.0 + std::log((double)silenceThreshold) / std::log(loopGain));
+    }
+
 private:
     juce::String procName;
+    std::array<std::atomic<float>, maxParams> paramSlots {};
+    std::atomic<uint32_t> pendingParams { 0 };
 };
 
 
@@ -103,7 +1020,7 @@ public:
         gain.setRampDurationSeconds(0.05);
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         juce::dsp::AudioBlock<float> block(buffer);
         gain.process(juce::dsp::ProcessContextReplacing<float>(block));
     }
@@ -130,17 +1047,38 @@ public:
         params.dryLevel = 0.4f;
     }
     
+    // Stereo uses one reverb across both channels. Any other count is treated
+    // as independent mono tracks, each with its own reverb, so unrelated
+    // channels never bleed into each other.
     void prepare(const juce::dsp::ProcessSpec& spec) override {
-        reverb.setSampleRate(spec.sampleRate);
+        // juce::Reverb is non-copyable, so the instances are held by pointer
+        const size_t numReverbs = spec.numChannels == 2 ? 1 : juce::jmax<size_t>(1, spec.numChannels);
+        while (reverbs.size() < numReverbs) reverbs.push_back(std::make_unique<juce::Reverb>());
+        reverbs.resize(numReverbs);
+        for (auto& reverb : reverbs) {
+            reverb->setSampleRate(spec.sampleRate);
+            reverb->setParameters(params);
+        }
     }
 
-    void reset() override { reverb.reset(); }
+    void reset() override {
+        for (auto& reverb : reverbs) reverb->reset();
+    }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
-        if (buffer.getNumChannels() == 1) {
-             reverb.processMono(buffer.getWritePointer(0), buffer.getNumSamples());
-        } else if (buffer.getNumChannels() == 2) {
-             reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
+    // The longest comb filter (1617 samples at 44.1 kHz) sets the decay. Its
+    // feedback is roomSize * 0.28 + 0.7 in juce::Reverb; damping only shortens it.
+    double getTailLengthSeconds() const override {
+        return feedbackTailSeconds(1617.0 / 44100.0, getQueuedParam(0) * 0.28 + 0.7);
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
+        if (buffer.getNumChannels() == 2 && reverbs.size() == 1) {
+            reverbs[0]->processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
+            return;
+        }
+        const int numChannels = juce::jmin(buffer.getNumChannels(), (int)reverbs.size());
+        for (int ch = 0; ch < numChannels; ++ch) {
+            reverbs[(size_t)ch]->processMono(buffer.getWritePointer(ch), buffer.getNumSamples());
         }
     }
 
@@ -150,7 +1088,7 @@ public:
         else if (index == 2) params.wetLevel = value;
         else if (index == 3) params.dryLevel = value;
         else if (index == 4) params.width = value;
-        reverb.setParameters(params);
+        for (auto& reverb : reverbs) reverb->setParameters(params);
     }
     float getParam(int index) override {
         if (index == 0) return params.roomSize;
@@ -162,50 +1100,144 @@ public:
     }
     int getNumParams() override { return 5; }
 
-    juce::Reverb reverb;
+    std::vector<std::unique_ptr<juce::Reverb>> reverbs;
     juce::Reverb::Parameters params;
 };
 
 // --- Delay ---
+// Circular-buffer delay. The buffer is sized from the prepared sample rate,
+// and when the delay is at least a block long the whole block is processed
+// as contiguous spans instead of sample by sample.
 class DelayProcessor : public BaseInternalProcessor {
 public:
-    DelayProcessor() : BaseInternalProcessor("Delay") {
-        delayLine.setMaximumDelayInSamples(192000); // Max ~4 sec at 48k
-    }
+    DelayProcessor() : BaseInternalProcessor("Delay") {}
+
+    static constexpr float maxDelaySeconds = 2.0f;
+    static constexpr double smoothingSeconds = 0.05;
 
     void prepare(const juce::dsp::ProcessSpec& spec) override {
         sampleRate = spec.sampleRate;
-        delayLine.prepare(spec);
-        updateDelay();
+        maxBlockSize = (int)spec.maximumBlockSize;
+        bufferSize = (int)std::ceil(maxDelaySeconds * sampleRate) + maxBlockSize + 2;
+        delayBuffer.setSize((int)spec.numChannels, bufferSize);
+        delayBuffer.clear();
+        delayTimes.allocate((size_t)maxBlockSize, true);
+        writePos = 0;
+
+        delaySamples.reset(sampleRate, smoothingSeconds);
+        delaySamples.setCurrentAndTargetValue(getTargetDelaySamples());
     }
 
-    void reset() override { delayLine.reset(); }
+    void reset() override {
+        delayBuffer.clear();
+        writePos = 0;
+    }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
-        auto numSamples = buffer.getNumSamples();
-        auto numChannels = buffer.getNumChannels();
+    double getTailLengthSeconds() const override {
+        const double delaySeconds = juce::jmax(1.0 / sampleRate, (double)mapRange(getQueuedParam(0), 0.0f, maxDelaySeconds));
+        return feedbackTailSeconds(delaySeconds, getQueuedParam(1));
+    }
 
-        for (int ch = 0; ch < numChannels; ++ch) {
-            auto* data = buffer.getWritePointer(ch);
-            for (int i = 0; i < numSamples; ++i) {
-                float input = data[i];
-                float delayedSample = delayLine.popSample(ch);
-                
-                // Simple feedback + mix
-                float nextInput = input + (delayedSample * feedback);
-                delayLine.pushSample(ch, nextInput);
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), delayBuffer.getNumChannels());
+
+        // Blocks larger than the prepared size are handled in prepared-size pieces
+        for (int start = 0; start < buffer.getNumSamples(); start += maxBlockSize) {
+            const int numSamples = juce::jmin(maxBlockSize, buffer.getNumSamples() - start);
 
-                data[i] = (input * (1.0f - mix)) + (delayedSample * mix);
+            if (delaySamples.isSmoothing()) {
+                for (int i = 0; i < numSamples; ++i) delayTimes[i] = delaySamples.getNextValue();
+                for (int ch = 0; ch < numChannels; ++ch)
+                    processVariable(buffer.getWritePointer(ch, start), delayBuffer.getWritePointer(ch), numSamples);
+            } else {
+                const float delay = delaySamples.getCurrentValue();
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    if ((int)delay >= numSamples)
+                        processSpans(buffer.getWritePointer(ch, start), delayBuffer.getWritePointer(ch), numSamples, delay);
+                    else
+                        processFixed(buffer.getWritePointer(ch, start), delayBuffer.getWritePointer(ch), numSamples, delay);
+                }
             }
+
+            writePos = (writePos + numSamples) % bufferSize;
         }
     }
 
-    void updateDelay() {
+    // Delay covers the whole block, so every read comes from earlier blocks and
+    // reads and writes never overlap. Split only where a pointer wraps.
+    void processSpans(float* data, float* delayData, int numSamples, float delay) {
+        const int delayInt = (int)delay;
+        const float frac = delay - (float)delayInt;
+        const float dry = 1.0f - mix;
+        const float wet = mix;
+        const float fb = feedback;
+
+        int write = writePos;
+        int read = wrap(writePos - delayInt);   // delayInt samples ago
+        int readPrev = wrap(read - 1);          // delayInt + 1 samples ago
+
+        for (int done = 0; done < numSamples;) {
+            const int len = juce::jmin(numSamples - done, bufferSize - write, bufferSize - read, bufferSize - readPrev);
+            const float* a = delayData + read;
+            const float* b = delayData + readPrev;
+            float* w = delayData + write;
+            float* x = data + done;
+
+            for (int i = 0; i < len; ++i) {
+                const float delayed = a[i] + frac * (b[i] - a[i]);
+                const float input = x[i];
+                w[i] = input + delayed * fb;
+                x[i] = input * dry + delayed * wet;
+            }
+
+            done += len;
+            write = wrap(write + len);
+            read = wrap(read + len);
+            readPrev = wrap(readPrev + len);
+        }
+    }
+
+    // Short constant delay: reads may hit samples written earlier in this block
+    void processFixed(float* data, float* delayData, int numSamples, float delay) {
+        for (int i = 0; i < numSamples; ++i) {
+            processSample(data[i], delayData, writePos + i, delay);
+        }
+    }
+
+    // Delay time ramping towards a new value
+    void processVariable(float* data, float* delayData, int numSamples) {
+        for (int i = 0; i < numSamples; ++i) {
+            processSample(data[i], delayData, writePos + i, delayTimes[i]);
+        }
+    }
+
+    inline void processSample(float& sample, float* delayData, int position, float delay) {
+        const int delayInt = (int)delay;
+        const float frac = delay - (float)delayInt;
+        const float a = delayData[wrap(position - delayInt)];
+        const float b = delayData[wrap(position - delayInt - 1)];
+        const float delayed = a + frac * (b - a);
+
+        // Simple feedback + mix
+        const float input = sample;
+        delayData[wrap(position)] = input + (delayed * feedback);
+        sample = (input * (1.0f - mix)) + (delayed * mix);
+    }
+
+    inline int wrap(int index) const {
+        index %= bufferSize;
+        return index < 0 ? index + bufferSize : index;
+    }
+
+    float getTargetDelaySamples() const {
         // Map 0-1 to 0-2 seconds
-        float delaySec = mapRange(timeParam, 0.0f, 2.0f);
-        float delaySamples = delaySec * (float)sampleRate;
-        if (delaySamples < 1.0f) delaySamples = 1.0f;
-        delayLine.setDelay(delaySamples);
+        float delaySec = mapRange(timeParam, 0.0f, maxDelaySeconds);
+        float delay = delaySec * (float)sampleRate;
+        return juce::jlimit(1.0f, juce::jmax(1.0f, (float)(bufferSize - maxBlockSize - 2)), delay);
+    }
+
+    void updateDelay() {
+        delaySamples.setTargetValue(getTargetDelaySamples());
     }
 
     void setParam(int index, float value) override {
@@ -221,8 +1253,13 @@ public:
     }
     int getNumParams() override { return 3; }
 
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine;
+    juce::AudioBuffer<float> delayBuffer;
+    juce::HeapBlock<float> delayTimes; // Per-sample delay while smoothing
+    juce::SmoothedValue<float> delaySamples { 1.0f };
     double sampleRate = 44100.0;
+    int maxBlockSize = 512;
+    int bufferSize = 1;
+    int writePos = 0;
     
     float timeParam = 0.25f; // 0-1 mapped to 0-2s
     float feedback = 0.5f;
@@ -234,10 +1271,35 @@ class DistortionProcessor : public BaseInternalProcessor {
 public:
     DistortionProcessor() : BaseInternalProcessor("Distortion") {}
 
+    enum Mode { Standard = 0, Fast, Oversampled };
+
     void prepare(const juce::dsp::ProcessSpec& spec) override {
-        shaper.prepare(spec);
-        shaper.functionToUse = [](float x) { return std::tanh(x); };
+        inputGain.prepare(spec);
+        outputGain.prepare(spec);
+
+        // 4x linear-phase oversampling for the highest quality mode. Its
+        // filters are rebuilt only for a new channel count and its buffers
+        // only for a new block size; otherwise re-preparing just clears them.
+        if (oversampling == nullptr || oversamplingChannels != spec.numChannels) {
+            oversampling = std::make_unique<juce::dsp::Oversampling<float>>(
+                spec.numChannels, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+            oversamplingChannels = spec.numChannels;
+            maxBlockSize = 0;
+        }
+        if (maxBlockSize != (int)spec.maximumBlockSize) {
+            maxBlockSize = (int)spec.maximumBlockSize;
+            oversampling->initProcessing(spec.maximumBlockSize);
+        } else {
+            oversampling->reset();
+        }
+        oversampledLatency = (int)oversampling->getLatencyInSamples();
+
         update();
+        updateLatency(getMode());
+    }
+
+    void reset() override {
+        if (oversampling) oversampling->reset();
     }
     
     void update() {
@@ -248,24 +1310,90 @@ public:
         outputGain.setGainLinear(1.0f / std::sqrt(driveAmount)); 
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    static Mode modeFor(float value) { return (Mode)juce::jlimit(0, 2, (int)std::round(value * 2.0f)); }
+    Mode getMode() const { return modeFor(mode); }
+
+    // Latency follows the queued mode, so it is reported from the setter's
+    // thread (and from prepare) rather than when the block applies it
+    void paramQueued(int index, float value) override {
+        if (index == 1) updateLatency(modeFor(value));
+    }
+
+    void updateLatency(Mode newMode) {
+        setLatencySamples(newMode == Oversampled ? oversampledLatency : 0);
+    }
+
+    // Rational (Pade 7/6) tanh approximation. Clamping keeps it bounded
+    // outside the range where the approximation is accurate.
+    static inline float fastTanh(float x) {
+        x = juce::jlimit(-5.0f, 5.0f, x);
+        const float x2 = x * x;
+        const float numerator = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        const float denominator = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+        return juce::jlimit(-1.0f, 1.0f, numerator / denominator);
+    }
+
+    // Branch-free loops so the compiler can inline and vectorize the shaper
+    static void shapeFast(juce::dsp::AudioBlock<float>& block) {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch) {
+            auto* data = block.getChannelPointer(ch);
+            for (size_t i = 0; i < block.getNumSamples(); ++i) data[i] = fastTanh(data[i]);
+        }
+    }
+
+    static void shapeStandard(juce::dsp::AudioBlock<float>& block) {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch) {
+            auto* data = block.getChannelPointer(ch);
+            for (size_t i = 0; i < block.getNumSamples(); ++i) data[i] = std::tanh(data[i]);
+        }
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         juce::dsp::AudioBlock<float> block(buffer);
         juce::dsp::ProcessContextReplacing<float> context(block);
         
         inputGain.process(context);
-        shaper.process(context);
+
+        switch (getMode()) {
+            case Standard: shapeStandard(block); break;
+            case Fast: shapeFast(block); break;
+            case Oversampled: {
+                for (size_t start = 0; start < block.getNumSamples(); start += (size_t)maxBlockSize) {
+                    auto subBlock = block.getSubBlock(start, juce::jmin((size_t)maxBlockSize, block.getNumSamples() - start));
+                    auto upsampled = oversampling->processSamplesUp(subBlock);
+                    shapeFast(upsampled);
+                    oversampling->processSamplesDown(subBlock);
+                }
+                break;
+            }
+        }
+
         outputGain.process(context);
     }
 
     void setParam(int index, float value) override {
         if (index == 0) { drive = value; update(); }
+        else if (index == 1) {
+            auto previous = getMode();
+            mode = value;
+            if (getMode() != previous && oversampling) oversampling->reset();
+            update();
+        }
     }
-    float getParam(int index) override { return drive; }
-    int getNumParams() override { return 1; }
+    float getParam(int index) override {
+        if (index == 0) return drive;
+        if (index == 1) return mode;
+        return 0.0f;
+    }
+    int getNumParams() override { return 2; }
 
     float drive = 0.5f; // 0-1
+    float mode = 0.0f; // 0 = std::tanh, 0.5 = fast tanh, 1 = fast tanh at 4x oversampling
+    int maxBlockSize = 0; // Block size the oversampling buffers are allocated for
     juce::dsp::Gain<float> inputGain, outputGain;
-    juce::dsp::WaveShaper<float> shaper;
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
+    juce::uint32 oversamplingChannels = 0;
+    std::atomic<int> oversampledLatency { 0 };
 };
 
 // --- Hard Clip ---
@@ -275,13 +1403,11 @@ public:
 
     void prepare(const juce::dsp::ProcessSpec& spec) override {}
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         float thresh = mapRange(threshold, 0.1f, 1.0f);
         for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
             auto* data = buffer.getWritePointer(ch);
-            for (int i = 0; i < buffer.getNumSamples(); ++i) {
-                data[i] = std::max(-thresh, std::min(thresh, data[i]));
-            }
+            juce::FloatVectorOperations::clip(data, data, -thresh, thresh, buffer.getNumSamples());
         }
     }
 
@@ -312,7 +1438,13 @@ public:
         chorus.setMix(mix);
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    // Centre delay plus the full modulation depth, fed back
+    double getTailLengthSeconds() const override {
+        const double loopSeconds = 2.0 * mapRange(getQueuedParam(2), 1.0f, 30.0f) / 1000.0;
+        return feedbackTailSeconds(loopSeconds, mapRange(getQueuedParam(3), -0.9f, 0.9f));
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         juce::dsp::AudioBlock<float> block(buffer);
         chorus.process(juce::dsp::ProcessContextReplacing<float>(block));
     }
@@ -357,7 +1489,14 @@ public:
         phaser.setMix(mix);
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    // Six first-order all-pass stages at the lowest swept frequency, fed back
+    double getTailLengthSeconds() const override {
+        const double lowestHz = 0.5 * mapRangeLog(getQueuedParam(2), 100.0f, 5000.0f);
+        const double loopSeconds = decaySeconds(6.0 / (juce::MathConstants<double>::twoPi * lowestHz));
+        return feedbackTailSeconds(loopSeconds, mapRange(getQueuedParam(3), -0.9f, 0.9f));
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         juce::dsp::AudioBlock<float> block(buffer);
         phaser.process(juce::dsp::ProcessContextReplacing<float>(block));
     }
@@ -401,7 +1540,13 @@ public:
         compressor.setRelease(mapRange(release, 20.0f, 500.0f));
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    // Silence in gives silence out, but the envelope must release before the
+    // compressor can be bypassed or it would resume still compressing
+    double getTailLengthSeconds() const override {
+        return decaySeconds(mapRange(getQueuedParam(3), 20.0f, 500.0f) / 1000.0);
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         juce::dsp::AudioBlock<float> block(buffer);
         compressor.process(juce::dsp::ProcessContextReplacing<float>(block));
     }
@@ -441,7 +1586,12 @@ public:
         limiter.setRelease(mapRange(release, 10.0f, 500.0f));
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    // As for the compressor, the envelope needs to release
+    double getTailLengthSeconds() const override {
+        return decaySeconds(mapRange(getQueuedParam(1), 10.0f, 500.0f) / 1000.0);
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         juce::dsp::AudioBlock<float> block(buffer);
         limiter.process(juce::dsp::ProcessContextReplacing<float>(block));
     }
@@ -462,6 +1612,61 @@ public:
     juce::dsp::Limiter<float> limiter;
 };
 
+// --- SIMD Channel Lanes ---
+// Recursive filters can't be vectorised along time, so wide buffers are
+// vectorised across channels instead: each group of Register::size()
+// channels is interleaved into one register-wide lane per channel, and a
+// single filter over SIMDRegister<float> runs the whole group at once.
+// Unused lanes in the last group carry silence.
+struct SIMDChannelLanes {
+    using Register = juce::dsp::SIMDRegister<float>;
+    static constexpr size_t numLanes = Register::SIMDNumElements;
+
+    void prepare(int numChannels, int maxBlockSize) {
+        numGroups = ((size_t)juce::jmax(0, numChannels) + numLanes - 1) / numLanes;
+        capacity = (size_t)juce::jmax(1, maxBlockSize);
+        block = juce::dsp::AudioBlock<Register>(storage, juce::jmax<size_t>(1, numGroups), capacity);
+        block.clear();
+    }
+
+    // Interleaves numSamples of the buffer, from start, into the lanes
+    void pack(const juce::AudioBuffer<float>& buffer, int start, size_t numSamples) {
+        for (size_t group = 0; group < numGroups; ++group) {
+            auto* lanes = reinterpret_cast<float*>(block.getChannelPointer(group));
+            for (size_t lane = 0; lane < numLanes; ++lane) {
+                const int ch = (int)(group * numLanes + lane);
+                if (ch < buffer.getNumChannels()) {
+                    const float* source = buffer.getReadPointer(ch, start);
+                    for (size_t i = 0; i < numSamples; ++i) lanes[i * numLanes + lane] = source[i];
+                } else {
+                    for (size_t i = 0; i < numSamples; ++i) lanes[i * numLanes + lane] = 0.0f;
+                }
+            }
+        }
+    }
+
+    void unpack(juce::AudioBuffer<float>& buffer, int start, size_t numSamples) const {
+        for (size_t group = 0; group < numGroups; ++group) {
+            const auto* lanes = reinterpret_cast<const float*>(block.getChannelPointer(group));
+            for (size_t lane = 0; lane < numLanes; ++lane) {
+                const int ch = (int)(group * numLanes + lane);
+                if (ch >= buffer.getNumChannels()) break;
+                float* dest = buffer.getWritePointer(ch, start);
+                for (size_t i = 0; i < numSamples; ++i) dest[i] = lanes[i * numLanes + lane];
+            }
+        }
+    }
+
+    juce::dsp::AudioBlock<Register> getGroup(size_t group, size_t start, size_t numSamples) {
+        return block.getSingleChannelBlock(group).getSubBlock(start, numSamples);
+    }
+
+    juce::HeapBlock<char> storage;
+    juce::dsp::AudioBlock<Register> block;
+    size_t numGroups = 0;
+    size_t capacity = 0;
+};
+
 // --- Filters (IIR) ---
 enum FilterType { LowPass, HighPass };
 class FilterProcessor : public BaseInternalProcessor {
@@ -470,23 +1675,122 @@ public:
     
     void prepare(const juce::dsp::ProcessSpec& spec) override {
         sampleRate = spec.sampleRate;
+        // Allocate a second-order coefficient set once; updates rewrite it in place
+        *filter.state = juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
         filter.prepare(spec);
-        update();
+
+        // Wide buffers run in SIMD lanes; the lane filters share the coefficients
+        laneFilters.clear();
+        if (spec.numChannels > 2) {
+            lanes.prepare((int)spec.numChannels, (int)spec.maximumBlockSize);
+            for (size_t group = 0; group < lanes.numGroups; ++group) {
+                auto laneFilter = std::make_unique<juce::dsp::IIR::Filter<SIMDChannelLanes::Register>>(filter.state);
+                laneFilter->reset();
+                laneFilters.push_back(std::move(laneFilter));
+            }
+        }
+
+        cutoffHz.reset(sampleRate, smoothingSeconds);
+        qValue.reset(sampleRate, smoothingSeconds);
+        cutoffHz.setCurrentAndTargetValue(getTargetCutoffHz());
+        qValue.setCurrentAndTargetValue(getTargetQ());
+        updateCoefficients(cutoffHz.getCurrentValue(), qValue.getCurrentValue());
+    }
+
+    void reset() override {
+        filter.reset();
+        for (auto& laneFilter : laneFilters) laneFilter->reset();
     }
     
     void update() {
-        float freqHz = mapRangeLog(cutoff, 20.0f, 20000.0f);
-        float qVal = mapRange(q, 0.1f, 10.0f);
-        
-        if (type == LowPass)
-            *filter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, freqHz, qVal);
-        else
-            *filter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, freqHz, qVal);
+        cutoffHz.setTargetValue(getTargetCutoffHz());
+        qValue.setTargetValue(getTargetQ());
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    float getTargetCutoffHz() const {
+        // Keep the cutoff below Nyquist so low sample rates stay stable
+        return juce::jmin(mapRangeLog(cutoff, 20.0f, 20000.0f), (float)sampleRate * 0.49f);
+    }
+
+    float getTargetQ() const { return mapRange(q, 0.1f, 10.0f); }
+
+    // A resonant biquad rings with time constant Q / (pi * f)
+    double getTailLengthSeconds() const override {
+        const double hz = mapRangeLog(getQueuedParam(0), 20.0f, 20000.0f);
+        const double qVal = juce::jmax(0.5f, mapRange(getQueuedParam(1), 0.1f, 10.0f));
+        return decaySeconds(qVal / (juce::MathConstants<double>::pi * hz));
+    }
+
+    // Same designs as IIR::Coefficients::makeLowPass/makeHighPass, written
+    // straight into the shared coefficient array so sweeps never allocate.
+    void updateCoefficients(float freqHz, float qVal) {
+        const float n = std::tan(juce::MathConstants<float>::pi * freqHz / (float)sampleRate);
+        const float nSquared = n * n;
+        const float invQ = 1.0f / qVal;
+        auto* c = filter.state->getRawCoefficients();
+
+        if (type == LowPass) {
+            const float invN = 1.0f / n;
+            const float invNSquared = invN * invN;
+            const float c1 = 1.0f / (1.0f + invQ * invN + invNSquared);
+            c[0] = c1;
+            c[1] = c1 * 2.0f;
+            c[2] = c1;
+            c[3] = c1 * 2.0f * (1.0f - invNSquared);
+            c[4] = c1 * (1.0f - invQ * invN + invNSquared);
+        } else {
+            const float c1 = 1.0f / (1.0f + invQ * n + nSquared);
+            c[0] = c1;
+            c[1] = c1 * -2.0f;
+            c[2] = c1;
+            c[3] = c1 * 2.0f * (nSquared - 1.0f);
+            c[4] = c1 * (1.0f - invQ * n + nSquared);
+        }
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
+        if (!laneFilters.empty()) {
+            processLanes(buffer);
+            return;
+        }
+
         juce::dsp::AudioBlock<float> block(buffer);
-        filter.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+        if (!cutoffHz.isSmoothing() && !qValue.isSmoothing()) {
+            filter.process(juce::dsp::ProcessContextReplacing<float>(block));
+            return;
+        }
+
+        // Recompute coefficients at control rate while a change is ramping
+        const auto numSamples = block.getNumSamples();
+        for (size_t start = 0; start < numSamples; start += smoothingStep) {
+            const auto len = juce::jmin(smoothingStep, numSamples - start);
+            updateCoefficients(cutoffHz.skip((int)len), qValue.skip((int)len));
+            auto subBlock = block.getSubBlock(start, len);
+            filter.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+        }
+    }
+
+    // Same as above, with every channel group filtered per coefficient step
+    void processLanes(juce::AudioBuffer<float>& buffer) {
+        const auto total = (size_t)buffer.getNumSamples();
+        for (size_t offset = 0; offset < total; offset += lanes.capacity) {
+            const auto numSamples = juce::jmin(lanes.capacity, total - offset);
+            lanes.pack(buffer, (int)offset, numSamples);
+
+            const bool smoothing = cutoffHz.isSmoothing() || qValue.isSmoothing();
+            const auto step = smoothing ? smoothingStep : numSamples;
+            for (size_t start = 0; start < numSamples; start += step) {
+                const auto len = juce::jmin(step, numSamples - start);
+                if (smoothing) updateCoefficients(cutoffHz.skip((int)len), qValue.skip((int)len));
+                for (size_t group = 0; group < laneFilters.size(); ++group) {
+                    auto block = lanes.getGroup(group, start, len);
+                    laneFilters[group]->process(juce::dsp::ProcessContextReplacing<SIMDChannelLanes::Register>(block));
+                }
+            }
+
+            lanes.unpack(buffer, (int)offset, numSamples);
+        }
     }
 
     void setParam(int index, float value) override {
@@ -501,10 +1805,17 @@ public:
     }
     int getNumParams() override { return 2; }
     
+    static constexpr double smoothingSeconds = 0.02;
+    static constexpr size_t smoothingStep = 32;
+
     FilterType type;
     double sampleRate = 44100.0;
     float cutoff = 0.5f, q = 0.1f;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> cutoffHz { 1000.0f };
+    juce::SmoothedValue<float> qValue { 1.0f };
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> filter;
+    SIMDChannelLanes lanes;
+    std::vector<std::unique_ptr<juce::dsp::IIR::Filter<SIMDChannelLanes::Register>>> laneFilters;
 };
 
 // --- Ladder Filter ---
@@ -525,7 +1836,16 @@ public:
         ladder.setDrive(mapRange(drive, 1.0f, 5.0f));
     }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    // Approximated as a biquad whose Q grows with resonance; at full
+    // resonance the filter can self-oscillate, so it never decays
+    double getTailLengthSeconds() const override {
+        const float res = getQueuedParam(1);
+        if (res >= 1.0f) return std::numeric_limits<double>::infinity();
+        const double hz = mapRangeLog(getQueuedParam(0), 20.0f, 20000.0f);
+        return decaySeconds((0.5 + 10.0 * res) / (juce::MathConstants<double>::pi * hz));
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         juce::dsp::AudioBlock<float> block(buffer);
         ladder.process(juce::dsp::ProcessContextReplacing<float>(block));
     }
@@ -553,29 +1873,83 @@ class BitcrushProcessor : public BaseInternalProcessor {
 public:
     BitcrushProcessor() : BaseInternalProcessor("Bitcrush") {}
 
-    void prepare(const juce::dsp::ProcessSpec& spec) override {}
+    void prepare(const juce::dsp::ProcessSpec& spec) override {
+        heldValues.assign(spec.numChannels, 0.0f);
+        holdRemaining = 0;
+    }
 
-    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+    void reset() override {
+        std::fill(heldValues.begin(), heldValues.end(), 0.0f);
+        holdRemaining = 0;
+    }
+
+    // A held sample lasts until the next downsampling step
+    double getTailLengthSeconds() const override {
+        const double sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+        return (int)mapRange(getQueuedParam(1), 1.0f, 50.0f) / sampleRate;
+    }
+
+    // Adding and subtracting 1.5 * 2^23 rounds to the nearest integer using
+    // plain float adds, so the quantizer vectorizes without floor(). That
+    // only holds while the scaled sample stays under 2^22 in magnitude, which
+    // up to 20 bits covers signals to +-8; deeper steps round with floor().
+    static constexpr float roundingMagic = 12582912.0f;
+    static constexpr int maxFastDepth = 20;
+
+    static float quantize(float value, float step, float invStep, bool fast) {
+        if (fast) return ((value * invStep + roundingMagic) - roundingMagic) * step;
+        return std::floor(value * invStep + 0.5f) * step;
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
         int depth = (int)mapRange(bitDepth, 32.0f, 2.0f); // Inverted so 0=32bit, 1=2bit
         int down = (int)mapRange(downsample, 1.0f, 50.0f);
+        const int numSamples = buffer.getNumSamples();
+        const int numChannels = buffer.getNumChannels();
         
-        float step = 1.0f / (float)(1 << (depth - 1));
-        
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-            auto* data = buffer.getWritePointer(ch);
-            float lastVal = 0.0f;
-            for (int i = 0; i < buffer.getNumSamples(); ++i) {
-                if (i % down == 0) {
-                    float val = data[i];
-                    // Quantize
-                    if (depth < 32) {
-                        val = std::floor(val / step + 0.5f) * step;
-                    }
-                    lastVal = val;
+        const bool quantizing = depth < 32; // 32 bits passes audio through
+        const bool fast = depth <= maxFastDepth;
+        const float step = quantizing ? 1.0f / (float)(1 << (depth - 1)) : 0.0f;
+        const float invStep = quantizing ? (float)(1 << (depth - 1)) : 0.0f;
+
+        if (down <= 1) {
+            for (int ch = 0; ch < numChannels && quantizing; ++ch) {
+                auto* data = buffer.getWritePointer(ch);
+                if (fast) {
+                    juce::FloatVectorOperations::multiply(data, invStep, numSamples);
+                    juce::FloatVectorOperations::add(data, roundingMagic, numSamples);
+                    juce::FloatVectorOperations::add(data, -roundingMagic, numSamples);
+                    juce::FloatVectorOperations::multiply(data, step, numSamples);
+                } else {
+                    for (int i = 0; i < numSamples; ++i) data[i] = quantize(data[i], step, invStep, false);
                 }
-                data[i] = lastVal;
             }
+            holdRemaining = 0;
+            return;
+        }
+
+        if ((int)heldValues.size() < numChannels) heldValues.resize((size_t)numChannels, 0.0f);
+
+        // Sample-and-hold as strided fills; the hold phase carries across blocks
+        int nextHoldRemaining = holdRemaining;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto* data = buffer.getWritePointer(ch);
+            float held = heldValues[(size_t)ch];
+
+            int i = juce::jmin(holdRemaining, numSamples);
+            juce::FloatVectorOperations::fill(data, held, i);
+            nextHoldRemaining = holdRemaining - i;
+
+            while (i < numSamples) {
+                held = quantizing ? quantize(data[i], step, invStep, fast) : data[i];
+                const int len = juce::jmin(down, numSamples - i);
+                juce::FloatVectorOperations::fill(data + i, held, len);
+                nextHoldRemaining = down - len;
+                i += len;
+            }
+            heldValues[(size_t)ch] = held;
         }
+        holdRemaining = nextHoldRemaining;
     }
 
     void setParam(int index, float value) override {
@@ -591,182 +1965,3388 @@ public:
 
     float bitDepth = 0.0f; // 0 (32bit) -> 1 (2bit)
     float downsample = 0.0f; // 0 (1x) -> 1 (50x)
+    std::vector<float> heldValues; // Per channel
+    int holdRemaining = 0; // Samples still to fill with heldValues, shared by all channels
 };
 
 
-// --- Factory ---
+// --- Convolution ---
+// An impulse response as loaded, before conversion to the processing rate.
+// key identifies its contents, so equal IRs share their spectra.
+struct ImpulseResponse {
+    juce::AudioBuffer<float> samples;
+    double sampleRate = 44100.0;
+    juce::String key;
+};
 
-PedalboardProcessor pedalboard_create_internal_processor(const char* name) {
-    juce::String processorName(name);
-    
-    std::unique_ptr<BaseInternalProcessor> proc;
+// Spectra for non-uniform partitioned convolution. Level 0 uses partitions
+// of the head size N and is convolved as each partition fills. Each later
+// level partitions four times longer and is deferred: a level with
+// partition P starts at IR offset 2P - N, one partition period more than its
+// buffering needs, so its work can be spread over the period after a
+// partition fills rather than done in the block that fills it. Either way
+// every level's output lines up at a latency of N. Level 0 covers seven
+// partitions, every later level but the last covers six. Immutable once
+// built, so one copy is shared by all the processors using the same IR,
+// rate and head size.
+struct ConvolutionSpectra {
+    struct Level {
+        int partitionSize = 0;
+        int numPartitions = 0;
+        bool deferred = false; // Starts a partition period late, to compute over it
+        std::vector<float> spectra; // [IR channel][partition][partitionSize + 1 complex bins]
 
-    if (processorName == "Gain") proc = std::make_unique<GainProcessor>();
-    else if (processorName == "Reverb") proc = std::make_unique<ReverbProcessor>();
-    else if (processorName == "Chorus") proc = std::make_unique<ChorusProcessor>();
-    else if (processorName == "Distortion") proc = std::make_unique<DistortionProcessor>();
-    else if (processorName == "Clipping") proc = std::make_unique<ClippingProcessor>();
-    else if (processorName == "Phaser") proc = std::make_unique<PhaserProcessor>();
-    else if (processorName == "Compressor") proc = std::make_unique<CompressorProcessor>();
-    else if (processorName == "Limiter") proc = std::make_unique<LimiterProcessor>();
-    else if (processorName == "Delay") proc = std::make_unique<DelayProcessor>();
-    else if (processorName == "LowPass") proc = std::make_unique<FilterProcessor>(LowPass);
-    else if (processorName == "HighPass") proc = std::make_unique<FilterProcessor>(HighPass);
-    else if (processorName == "LadderFilter") proc = std::make_unique<LadderProcessor>();
-    else if (processorName == "Bitcrush") proc = std::make_unique<BitcrushProcessor>();
+        size_t getSpectrumSize() const { return 2 * (size_t)partitionSize + 2; }
+        const float* getSpectrum(int irChannel, int partition) const {
+            return spectra.data() + ((size_t)irChannel * (size_t)numPartitions + (size_t)partition) * getSpectrumSize();
+        }
+    };
 
-    if (proc) {
-        auto wrapper = new ProcessorWrapper();
-        wrapper->processor = std::move(proc);
-        return static_cast<PedalboardProcessor>(wrapper);
-    }
-    
-    return nullptr;
-}
+    int headSize = 0;
+    int numChannels = 0;
+    int length = 0; // IR samples at sampleRate
+    double sampleRate = 0.0;
+    std::vector<Level> levels;
+};
 
-// ... Rest of the file (LoadPlugin, AudioIO, Stream) ...
+static constexpr int maxConvolutionPartition = 16384;
 
-PedalboardProcessor pedalboard_load_plugin(const char* path) {
-    pedalboard_init();
-    juce::File file(path);
-    juce::OwnedArray<juce::PluginDescription> descriptions;
-    
-    for (int i = 0; i < g_internal->pluginFormatManager.getNumFormats(); ++i) {
-        auto* format = g_internal->pluginFormatManager.getFormat(i);
-        format->findAllTypesForFile(descriptions, path);
-        if (descriptions.size() > 0) break;
+// Real-only inverse transforms take the full spectrum; rebuild the upper
+// half of an fftSize-point spectrum from the lower by conjugate symmetry.
+static void fillNegativeFrequencies(float* spectrum, int fftSize) {
+    for (int bin = 1; bin < fftSize / 2; ++bin) {
+        spectrum[2 * (fftSize - bin)] = spectrum[2 * bin];
+        spectrum[2 * (fftSize - bin) + 1] = -spectrum[2 * bin + 1];
     }
-    
-    if (descriptions.size() == 0) return nullptr;
-    
-    juce::String error;
-    auto plugin = g_internal->pluginFormatManager.createPluginInstance(*descriptions[0], 44100.0, 512, error);
-    if (plugin == nullptr) return nullptr;
-    
-    auto wrapper = new ProcessorWrapper();
-    wrapper->processor = std::move(plugin);
-    return static_cast<PedalboardProcessor>(wrapper);
 }
 
-PedalboardAudioBuffer* pedalboard_load_audio_file(const char* path) {
-    pedalboard_init();
-    juce::File file(path);
-    std::unique_ptr<juce::AudioFormatReader> reader(g_internal->formatManager.createReaderFor(file));
-    if (reader == nullptr) return nullptr;
-    
-    auto* result = new PedalboardAudioBuffer();
-    result->num_channels = (int)reader->numChannels;
-    result->num_samples = (int)reader->lengthInSamples;
-    result->sample_rate = reader->sampleRate;
-    
-    result->data = (float**)malloc(sizeof(float*) * result->num_channels);
-    for (int i = 0; i < result->num_channels; ++i) {
-        result->data[i] = (float*)malloc(sizeof(float) * result->num_samples);
+static void complexMultiplyAccumulate(float* accumulator, const float* a, const float* b, int numBins) {
+    for (int i = 0; i < 2 * numBins; i += 2) {
+        accumulator[i] += a[i] * b[i] - a[i + 1] * b[i + 1];
+        accumulator[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
     }
-    
-    juce::AudioBuffer<float> tempBuffer(result->data, result->num_channels, result->num_samples);
-    reader->read(&tempBuffer, 0, result->num_samples, 0, true, true);
-    return result;
 }
 
-void pedalboard_save_audio_file(const char* path, PedalboardAudioBuffer* buffer) {
-    if (buffer == nullptr) return;
-    pedalboard_init();
-    juce::File file(path);
-    if (file.existsAsFile()) file.deleteFile();
-    
-    auto* format = g_internal->formatManager.findFormatForFileExtension(file.getFileExtension());
-    if (format == nullptr) format = g_internal->formatManager.getDefaultFormat();
-    if (format == nullptr) return;
-    
-    auto* stream = new juce::FileOutputStream(file);
-    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream, 
-                                                                         buffer->sample_rate, 
-                                                                         (unsigned int)buffer->num_channels, 
-                                                                         16, 
-                                                                         {}, 
-                                                                         0));
-    
-    if (writer != nullptr) {
-        juce::AudioBuffer<float> tempBuffer(buffer->data, buffer->num_channels, buffer->num_samples);
-        writer->writeFromAudioSampleBuffer(tempBuffer, 0, buffer->num_samples);
-    }
+// Round-trip gain of this FFT order, which differs between FFT engines.
+// Folding its inverse into the IR spectra saves scaling every output block.
+static float getFFTRoundTripGain(const juce::dsp::FFT& fft) {
+    std::vector<float> data((size_t)fft.getSize() * 2, 0.0f);
+    data[0] = 1.0f;
+    fft.performRealOnlyForwardTransform(data.data(), true);
+    fillNegativeFrequencies(data.data(), fft.getSize());
+    fft.performRealOnlyInverseTransform(data.data());
+    return data[0];
 }
 
-void pedalboard_audio_buffer_free(PedalboardAudioBuffer* buffer) {
-    if (buffer == nullptr) return;
-    for (int i = 0; i < buffer->num_channels; ++i) {
-        free(buffer->data[i]);
-    }
-    free(buffer->data);
-    delete buffer;
-}
+// Converts an IR to the processing rate, scaling it so its gain is
+// unchanged. As in StreamingResampler, converting down first low-passes below
+// the target Nyquist; the interpolator's delay is skipped so the IR's onset
+// stays at sample 0.
+static juce::AudioBuffer<float> resampleImpulseResponse(const ImpulseResponse& ir, double sampleRate) {
+    if (std::abs(ir.sampleRate - sampleRate) < 1.0e-6) return ir.samples;
 
-void pedalboard_processor_free(PedalboardProcessor processor) {
-    if (processor) delete static_cast<ProcessorWrapper*>(processor);
-}
+    const double ratio = ir.sampleRate / sampleRate;
+    const int latency = juce::WindowedSincInterpolator::getBaseLatency();
+    const int inputLength = ir.samples.getNumSamples();
+    const int outputLength = juce::jmax(1, (int)std::ceil(inputLength / ratio));
+    const int skip = juce::roundToInt(latency / ratio);
+    juce::AudioBuffer<float> output(ir.samples.getNumChannels(), outputLength);
 
-void pedalboard_processor_set_parameter(PedalboardProcessor processor, int index, float value) {
-    if (!processor) return;
-    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
-    
-    // Check if it's our internal base class
-    if (auto* internal = dynamic_cast<BaseInternalProcessor*>(wrapper->processor.get())) {
-        internal->setParam(index, value);
-        return;
+    juce::dsp::FilterDesign<float>::IIRCoefficients antiAliasing;
+    if (sampleRate < ir.sampleRate) {
+        antiAliasing = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((float)(sampleRate * 0.45), ir.sampleRate, 8);
     }
 
-    // External plugin
-    auto& params = wrapper->processor->getParameters();
-    if (index >= 0 && index < params.size()) {
-        params[index]->setValueNotifyingHost(value);
+    // Padded so the interpolator can read past the end of the IR
+    std::vector<float> padded((size_t)inputLength + (size_t)(2 * latency) + (size_t)std::ceil(ratio) + 16, 0.0f);
+    std::vector<float> resampled((size_t)(outputLength + skip));
+    for (int ch = 0; ch < ir.samples.getNumChannels(); ++ch) {
+        std::fill(padded.begin(), padded.end(), 0.0f);
+        std::copy_n(ir.samples.getReadPointer(ch), inputLength, padded.begin());
+        for (auto* section : antiAliasing) {
+            juce::dsp::IIR::Filter<float> filter(section);
+            for (auto& sample : padded) sample = filter.processSample(sample);
+        }
+
+        juce::WindowedSincInterpolator interpolator;
+        interpolator.process(ratio, padded.data(), resampled.data(), (int)resampled.size());
+        juce::FloatVectorOperations::multiply(output.getWritePointer(ch), resampled.data() + skip, (float)ratio, outputLength);
     }
+    return output;
 }
 
-float pedalboard_processor_get_parameter(PedalboardProcessor processor, int index) {
-    if (!processor) return 0.0f;
-    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
-    
-    if (auto* internal = dynamic_cast<BaseInternalProcessor*>(wrapper->processor.get())) {
-        return internal->getParam(index);
-    }
+static std::shared_ptr<const ConvolutionSpectra> buildConvolutionSpectra(const juce::AudioBuffer<float>& ir, double sampleRate, int headSize) {
+    auto result = std::make_shared<ConvolutionSpectra>();
+    result->headSize = headSize;
+    result->numChannels = ir.getNumChannels();
+    result->length = ir.getNumSamples();
+    result->sampleRate = sampleRate;
 
-    auto& params = wrapper->processor->getParameters();
-    if (index >= 0 && index < params.size()) {
-        return params[index]->getValue();
+    const int length = ir.getNumSamples();
+    const int largestPartition = juce::jmax(headSize, maxConvolutionPartition);
+    for (int partitionSize = headSize, start = 0; start < length; partitionSize *= 4) {
+        const int nextStart = 2 * (4 * partitionSize) - headSize;
+        const int end = (4 * partitionSize > largestPartition || nextStart >= length) ? length : nextStart;
+
+        ConvolutionSpectra::Level level;
+        level.partitionSize = partitionSize;
+        level.numPartitions = (end - start + partitionSize - 1) / partitionSize;
+        level.deferred = start > 0;
+        level.spectra.resize((size_t)result->numChannels * (size_t)level.numPartitions * level.getSpectrumSize());
+
+        juce::dsp::FFT fft(juce::roundToInt(std::log2(2.0 * partitionSize)));
+        const float scale = 1.0f / getFFTRoundTripGain(fft);
+        std::vector<float> buffer((size_t)fft.getSize() * 2);
+        for (int ch = 0; ch < result->numChannels; ++ch) {
+            for (int p = 0; p < level.numPartitions; ++p) {
+                const int offset = start + p * partitionSize;
+                const int count = juce::jmin(partitionSize, end - offset);
+                std::fill(buffer.begin(), buffer.end(), 0.0f);
+                std::copy_n(ir.getReadPointer(ch, offset), count, buffer.begin());
+                fft.performRealOnlyForwardTransform(buffer.data(), true);
+
+                float* spectrum = level.spectra.data() + ((size_t)ch * (size_t)level.numPartitions + (size_t)p) * level.getSpectrumSize();
+                juce::FloatVectorOperations::multiply(spectrum, buffer.data(), scale, (int)level.getSpectrumSize());
+            }
+        }
+
+        result->levels.push_back(std::move(level));
+        start = end;
     }
-    return 0.0f;
+    return result;
 }
 
-int pedalboard_processor_get_num_parameters(PedalboardProcessor processor) {
-    if (!processor) return 0;
-    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
-    
-    if (auto* internal = dynamic_cast<BaseInternalProcessor*>(wrapper->processor.get())) {
-        return internal->getNumParams();
+// Returns the shared spectra for an IR at a rate and head size, building
+// them only if no live processor already has them.
+static std::shared_ptr<const ConvolutionSpectra> getConvolutionSpectra(const ImpulseResponse& ir, double sampleRate, int headSize) {
+    const auto key = ir.key + "|" + juce::String(sampleRate) + "|" + juce::String(headSize);
+    auto& cache = g_internal->convolutionSpectra;
+    {
+        const juce::ScopedLock sl(g_internal->convolutionLock);
+        auto found = cache.find(key);
+        if (found != cache.end()) {
+            if (auto spectra = found->second.lock()) return spectra;
+        }
     }
 
-    return wrapper->processor->getParameters().size();
-}
+    // Built outside the lock; if another thread raced us, keep its copy
+    auto built = buildConvolutionSpectra(resampleImpulseResponse(ir, sampleRate), sampleRate, headSize);
 
-void pedalboard_processor_process(PedalboardProcessor processor, float** samples, int num_channels, int num_samples, double sample_rate) {
-    if (!processor) return;
+    const juce::ScopedLock sl(g_internal->convolutionLock);
+    for (auto it = cache.begin(); it != cache.end();) {
+        it = it->second.expired() ? cache.erase(it) : std::next(it);
+    }
+    auto& entry = cache[key];
+    if (auto existing = entry.lock()) return existing;
+    entry = built;
+    return built;
+}
+
+// Registers a loaded IR so processors restored from state (clones, pools)
+// find it by key. Returns the registered copy if one already exists.
+static std::shared_ptr<const ImpulseResponse> shareImpulseResponse(std::shared_ptr<const ImpulseResponse> ir) {
+    const juce::ScopedLock sl(g_internal->convolutionLock);
+    auto& entry = g_internal->impulseResponses[ir->key];
+    if (auto existing = entry.lock()) return existing;
+    entry = ir;
+    return ir;
+}
+
+static std::shared_ptr<const ImpulseResponse> findImpulseResponse(const juce::String& key) {
+    const juce::ScopedLock sl(g_internal->convolutionLock);
+    auto found = g_internal->impulseResponses.find(key);
+    return found != g_internal->impulseResponses.end() ? found->second.lock() : nullptr;
+}
+
+// Per-processor convolution state over shared spectra: each level's ring
+// of input partitions, its output for the partition playing and the one
+// being computed, and its history of input spectra. The dry signal is
+// delayed by the head size to stay aligned with the wet signal.
+//
+// Convolving one partition is a job of units, per channel: the forward FFT,
+// one multiply per IR partition, and the inverse FFT. Level 0 runs its job
+// as soon as a partition fills. A deferred level runs its job's units in
+// proportion to how far the next partition has filled, so a block does
+// about its share of every level's work, plus at most one unit. Without
+// that, every level would finish in the same block every 16384 samples,
+// costing about as much as the whole IR.
+class ConvolutionEngine {
+public:
+    ConvolutionEngine(std::shared_ptr<const ConvolutionSpectra> s, int channels, int maxBlockSize)
+        : spectra(std::move(s)), numChannels(channels) {
+        for (const auto& source : spectra->levels) {
+            Level level;
+            level.spectra = &source;
+            level.fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(2.0 * source.partitionSize)));
+            const auto partitionSize = (size_t)source.partitionSize;
+            level.inputs.assign((size_t)numChannels * inputSlots * partitionSize, 0.0f);
+            level.outputs.assign(2 * (size_t)numChannels * partitionSize, 0.0f);
+            level.history.assign((size_t)numChannels * (size_t)source.numPartitions * source.getSpectrumSize(), 0.0f);
+            level.scratch.assign(4 * partitionSize, 0.0f);
+            level.accumulator.assign(4 * partitionSize, 0.0f);
+            levels.push_back(std::move(level));
+        }
+        wet.setSize(numChannels, juce::jmax(1, maxBlockSize));
+        dry.setSize(numChannels, spectra->headSize);
+        reset();
+    }
+
+    void reset() {
+        for (auto& level : levels) {
+            std::fill(level.inputs.begin(), level.inputs.end(), 0.0f);
+            std::fill(level.outputs.begin(), level.outputs.end(), 0.0f);
+            std::fill(level.history.begin(), level.history.end(), 0.0f);
+            level.position = 0;
+            level.inputSlot = 0;
+            level.historyPosition = 0;
+            level.playing = 0;
+            level.job = {};
+        }
+        dry.clear();
+        dryPosition = 0;
+    }
+
+    int getLatency() const { return spectra->headSize; }
+    double getLengthSeconds() const { return spectra->length / spectra->sampleRate; }
+
+    void process(juce::AudioBuffer<float>& buffer, float mix) {
+        const int channels = juce::jmin(buffer.getNumChannels(), numChannels);
+        for (int start = 0; start < buffer.getNumSamples(); start += wet.getNumSamples()) {
+            const int numSamples = juce::jmin(wet.getNumSamples(), buffer.getNumSamples() - start);
+            wet.clear(0, numSamples);
+            for (auto& level : levels) processLevel(level, buffer, channels, start, numSamples);
+            mixDry(buffer, channels, start, numSamples, mix);
+        }
+    }
+
+private:
+    // The partition filling, and the two before it that a deferred job reads
+    static constexpr int inputSlots = 3;
+
+    // The convolution of one filled partition
+    struct Job {
+        int slot = 0;          // Input slot of the filled partition
+        int historySlot = 0;   // Where its spectrum goes
+        int channels = 0;
+        int numUnits = 0;
+        int unitsDone = 0;
+    };
+
+    struct Level {
+        const ConvolutionSpectra::Level* spectra = nullptr;
+        std::unique_ptr<juce::dsp::FFT> fft;
+        int position = 0;        // Samples buffered in the current partition
+        int inputSlot = 0;       // Slot the current partition fills
+        int historyPosition = 0; // Slot the next input spectrum goes in
+        int playing = 0;         // Which half of outputs is playing
+        Job job;
+        std::vector<float> inputs;   // [channel][inputSlots][partitionSize]
+        std::vector<float> outputs;  // [2][channel][partitionSize]: playing, and being computed
+        std::vector<float> history;  // [channel][numPartitions][spectrum]
+        std::vector<float> scratch, accumulator; // For the channel the job is on
+
+        float* getInput(int ch, int slot) {
+            return inputs.data() + ((size_t)ch * inputSlots + (size_t)slot) * (size_t)spectra->partitionSize;
+        }
+        float* getOutput(int half, int ch) {
+            return outputs.data() + ((size_t)half * (outputs.size() / 2)) + (size_t)ch * (size_t)spectra->partitionSize;
+        }
+    };
+
+    void processLevel(Level& level, const juce::AudioBuffer<float>& buffer, int channels, int start, int numSamples) {
+        const int partitionSize = level.spectra->partitionSize;
+        for (int done = 0; done < numSamples;) {
+            const int count = juce::jmin(partitionSize - level.position, numSamples - done);
+            for (int ch = 0; ch < channels; ++ch) {
+                std::copy_n(buffer.getReadPointer(ch, start + done), count, level.getInput(ch, level.inputSlot) + level.position);
+                juce::FloatVectorOperations::add(wet.getWritePointer(ch, done), level.getOutput(level.playing, ch) + level.position, count);
+            }
+            level.position += count;
+            done += count;
+
+            if (level.position == partitionSize) {
+                finishPartition(level, channels);
+            } else if (level.spectra->deferred) {
+                // Keep pace with the partition filling, so the job is done when it is
+                const auto due = ((juce::int64)level.job.numUnits * level.position + partitionSize - 1) / partitionSize;
+                runUnits(level, (int)due);
+            }
+        }
+    }
+
+    // A deferred level finishes the previous partition's job, which plays
+    // next, then starts this one's; level 0 runs this one's and plays it.
+    void finishPartition(Level& level, int channels) {
+        if (level.spectra->deferred) {
+            runUnits(level, level.job.numUnits);
+            level.playing = 1 - level.playing;
+            startJob(level, channels);
+        } else {
+            startJob(level, channels);
+            runUnits(level, level.job.numUnits);
+            level.playing = 1 - level.playing;
+        }
+        level.position = 0;
+        level.inputSlot = (level.inputSlot + 1) % inputSlots;
+    }
+
+    void startJob(Level& level, int channels) {
+        const int partitionSize = level.spectra->partitionSize;
+        level.job.slot = level.inputSlot;
+        level.job.historySlot = level.historyPosition;
+        level.job.channels = channels;
+        level.job.numUnits = channels * (level.spectra->numPartitions + 2);
+        level.job.unitsDone = 0;
+        level.historyPosition = (level.historyPosition + 1) % level.spectra->numPartitions;
+
+        // Channels not passed this partition play silence rather than what they last held
+        for (int ch = channels; ch < numChannels; ++ch) {
+            std::fill_n(level.getOutput(1 - level.playing, ch), partitionSize, 0.0f);
+        }
+    }
+
+    void runUnits(Level& level, int target) {
+        while (level.job.unitsDone < target) runUnit(level, level.job.unitsDone++);
+    }
+
+    // Uniform overlap-save over one level, a unit at a time: transform the
+    // newest 2P input samples, multiply the input history by each IR
+    // partition, and keep the last P samples of the inverse transform.
+    void runUnit(Level& level, int unit) {
+        const auto& source = *level.spectra;
+        const int partitionSize = source.partitionSize;
+        const int numPartitions = source.numPartitions;
+        const auto spectrumSize = source.getSpectrumSize();
+        const int unitsPerChannel = numPartitions + 2;
+        const int ch = unit / unitsPerChannel;
+        const int step = unit % unitsPerChannel;
+        float* history = level.history.data() + (size_t)ch * (size_t)numPartitions * spectrumSize;
+
+        if (step == 0) {
+            const int previousSlot = (level.job.slot + inputSlots - 1) % inputSlots;
+            std::copy_n(level.getInput(ch, previousSlot), partitionSize, level.scratch.begin());
+            std::copy_n(level.getInput(ch, level.job.slot), partitionSize, level.scratch.begin() + partitionSize);
+            std::fill(level.scratch.begin() + 2 * partitionSize, level.scratch.end(), 0.0f);
+            level.fft->performRealOnlyForwardTransform(level.scratch.data(), true);
+            std::copy_n(level.scratch.begin(), spectrumSize, history + (size_t)level.job.historySlot * spectrumSize);
+            std::fill(level.accumulator.begin(), level.accumulator.end(), 0.0f);
+        } else if (step <= numPartitions) {
+            const int p = step - 1;
+            const int slot = (level.job.historySlot - p + numPartitions) % numPartitions;
+            complexMultiplyAccumulate(level.accumulator.data(), history + (size_t)slot * spectrumSize,
+                                      source.getSpectrum(ch % spectra->numChannels, p), partitionSize + 1);
+        } else {
+            fillNegativeFrequencies(level.accumulator.data(), 2 * partitionSize);
+            level.fft->performRealOnlyInverseTransform(level.accumulator.data());
+            std::copy_n(level.accumulator.begin() + partitionSize, partitionSize, level.getOutput(1 - level.playing, ch));
+        }
+    }
+
+    void mixDry(juce::AudioBuffer<float>& buffer, int channels, int start, int numSamples, float mix) {
+        const int delay = dry.getNumSamples();
+        int position = dryPosition;
+        for (int ch = 0; ch < channels; ++ch) {
+            float* data = buffer.getWritePointer(ch, start);
+            float* ring = dry.getWritePointer(ch);
+            const float* wetData = wet.getReadPointer(ch);
+            position = dryPosition;
+            for (int i = 0; i < numSamples; ++i) {
+                const float delayed = ring[position];
+                ring[position] = data[i];
+                data[i] = delayed * (1.0f - mix) + wetData[i] * mix;
+                if (++position == delay) position = 0;
+            }
+        }
+        dryPosition = position;
+    }
+
+    std::shared_ptr<const ConvolutionSpectra> spectra;
+    std::vector<Level> levels;
+    int numChannels = 0;
+    juce::AudioBuffer<float> wet;
+    juce::AudioBuffer<float> dry; // Ring of headSize samples per channel
+    int dryPosition = 0;
+};
+
+// Convolves with an impulse response loaded through the C API. The engine
+// is rebuilt off the audio thread whenever the IR, head size or prepared
+// configuration changes, then published through an atomic pointer; the old
+// one is freed once the audio thread has moved on, so a block never waits
+// for a rebuild or runs without an engine. Without an IR the input passes
+// through unchanged.
+class ConvolutionProcessor : public BaseInternalProcessor {
+public:
+    ConvolutionProcessor() : BaseInternalProcessor("Convolution") {}
+
+    static constexpr int minHeadSize = 32;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override {
+        {
+            const juce::ScopedLock sl(configLock);
+            sampleRate = spec.sampleRate;
+            numChannels = (int)spec.numChannels;
+            maxBlockSize = (int)spec.maximumBlockSize;
+        }
+        rebuild();
+    }
+
+    void reset() override {
+        const AudioThreadGuard::Scope scope(audioThread);
+        if (auto* current = activeEngine.load()) current->reset();
+    }
+
+    void processAudio(juce::AudioBuffer<float>& buffer) override {
+        const AudioThreadGuard::Scope scope(audioThread);
+        if (auto* current = activeEngine.load()) current->process(buffer, mix);
+    }
+
+    // Thread-safe. Takes effect immediately if the processor is prepared.
+    void setImpulseResponse(std::shared_ptr<const ImpulseResponse> ir) {
+        {
+            const juce::ScopedLock sl(configLock);
+            impulseResponse = std::move(ir);
+        }
+        rebuild();
+    }
+
+    // 0 uses the prepared block size, the lowest latency available
+    void setHeadSize(int numSamples) {
+        {
+            const juce::ScopedLock sl(configLock);
+            requestedHeadSize = juce::jmax(0, numSamples);
+        }
+        rebuild();
+    }
+
+    double getTailLengthSeconds() const override { return tailSeconds.load(std::memory_order_relaxed); }
+
+    // State adds the IR's key and head size; a restored processor finds the
+    // IR if any live processor still holds it
+    void getStateInformation(juce::MemoryBlock& destData) override {
+        BaseInternalProcessor::getStateInformation(destData);
+        juce::MemoryOutputStream stream(destData, true);
+        const juce::ScopedLock sl(configLock);
+        stream.writeString(impulseResponse ? impulseResponse->key : juce::String());
+        stream.writeInt(requestedHeadSize);
+    }
+
+    void setStateInformation(const void* data, int sizeInBytes) override {
+        BaseInternalProcessor::setStateInformation(data, sizeInBytes);
+        juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+        if (stream.readString() != getName()) return;
+        const int numParams = stream.readInt();
+        stream.skipNextBytes((juce::int64)numParams * (juce::int64)sizeof(float));
+        if (stream.isExhausted()) return;
+
+        const auto key = stream.readString();
+        const int headSize = stream.readInt();
+        {
+            const juce::ScopedLock sl(configLock);
+            requestedHeadSize = juce::jmax(0, headSize);
+            if (key.isNotEmpty() && g_internal != nullptr) impulseResponse = findImpulseResponse(key);
+        }
+        rebuild();
+    }
+
+    void setParam(int index, float value) override {
+        if (index == 0) mix = value;
+    }
+    float getParam(int index) override {
+        if (index == 0) return mix;
+        return 0.0f;
+    }
+    int getNumParams() override { return 1; }
+
+private:
+    // configLock also serialises rebuilds, so engines are published in the
+    // order they were configured; the audio thread never takes it
+    void rebuild() {
+        std::unique_ptr<ConvolutionEngine> newEngine;
+        int latency = 0;
+        {
+            const juce::ScopedLock sl(configLock);
+            if (impulseResponse != nullptr && sampleRate > 0.0 && numChannels > 0) {
+                const int headSize = (int)juce::nextPowerOfTwo(juce::jmax(minHeadSize, requestedHeadSize > 0 ? requestedHeadSize : maxBlockSize));
+                newEngine = std::make_unique<ConvolutionEngine>(getConvolutionSpectra(*impulseResponse, sampleRate, headSize),
+                                                                numChannels, maxBlockSize);
+            }
+
+            latency = newEngine ? newEngine->getLatency() : 0;
+            tailSeconds.store(newEngine ? newEngine->getLengthSeconds() : 0.0, std::memory_order_relaxed);
+            activeEngine.store(newEngine.get());
+            audioThread.waitForAudioThread();
+            std::swap(engine, newEngine);
+        }
+        setLatencySamples(latency);
+        // The previous engine is freed here, off the audio thread
+    }
+
+    juce::CriticalSection configLock;
+    std::shared_ptr<const ImpulseResponse> impulseResponse;
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    int maxBlockSize = 512;
+    int requestedHeadSize = 0;
+
+    std::unique_ptr<ConvolutionEngine> engine;              // Owned; replaced whole by rebuild
+    std::atomic<ConvolutionEngine*> activeEngine { nullptr }; // What the audio thread runs
+    AudioThreadGuard audioThread;
+    std::atomic<double> tailSeconds { 0.0 };
+    float mix = 1.0f;
+};
+
+// --- Factory ---
+
+// Every name createInternalProcessor accepts, in the order they are listed
+// to callers. Keep the two in sync when adding a processor.
+static const char* const internalProcessorNames[] = {
+    "Gain", "Reverb", "Chorus", "Distortion", "Clipping", "Phaser", "Compressor",
+    "Limiter", "Delay", "LowPass", "HighPass", "LadderFilter", "Bitcrush", "Convolution"
+};
+
+static std::unique_ptr<BaseInternalProcessor> createInternalProcessor(const juce::String& processorName) {
+    std::unique_ptr<BaseInternalProcessor> proc;
+
+    if (processorName == "Gain") proc = std::make_unique<GainProcessor>();
+    else if (processorName == "Reverb") proc = std::make_unique<ReverbProcessor>();
+    else if (processorName == "Chorus") proc = std::make_unique<ChorusProcessor>();
+    else if (processorName == "Distortion") proc = std::make_unique<DistortionProcessor>();
+    else if (processorName == "Clipping") proc = std::make_unique<ClippingProcessor>();
+    else if (processorName == "Phaser") proc = std::make_unique<PhaserProcessor>();
+    else if (processorName == "Compressor") proc = std::make_unique<CompressorProcessor>();
+    else if (processorName == "Limiter") proc = std::make_unique<LimiterProcessor>();
+    else if (processorName == "Delay") proc = std::make_unique<DelayProcessor>();
+    else if (processorName == "LowPass") proc = std::make_unique<FilterProcessor>(LowPass);
+    else if (processorName == "HighPass") proc = std::make_unique<FilterProcessor>(HighPass);
+    else if (processorName == "LadderFilter") proc = std::make_unique<LadderProcessor>();
+    else if (processorName == "Bitcrush") proc = std::make_unique<BitcrushProcessor>();
+    else if (processorName == "Convolution") proc = std::make_unique<ConvolutionProcessor>();
+
+    if (proc) proc->syncParamSlots();
+    return proc;
+}
+
+int pedalboard_get_num_internal_processors() {
+    return (int)(sizeof(internalProcessorNames) / sizeof(internalProcessorNames[0]));
+}
+
+const char* pedalboard_get_internal_processor_name(int index) {
+    if (index < 0 || index >= pedalboard_get_num_internal_processors()) return nullptr;
+    return internalProcessorNames[index];
+}
+
+PedalboardProcessor pedalboard_create_internal_processor(const char* name) {
+    auto proc = createInternalProcessor(juce::String(name));
+
+    if (proc) {
+        auto wrapper = new ProcessorWrapper();
+        wrapper->processor = std::move(proc);
+        wrapper->kind = ProcessorWrapper::Kind::internal;
+        return static_cast<PedalboardProcessor>(wrapper);
+    }
+    
+    return nullptr;
+}
+
+static ConvolutionProcessor* getConvolutionProcessor(PedalboardProcessor processor) {
+    if (processor == nullptr) return nullptr;
     auto* wrapper = static_cast<ProcessorWrapper*>(processor);
-    juce::AudioBuffer<float> buffer(samples, num_channels, num_samples);
+    if (wrapper->kind != ProcessorWrapper::Kind::internal) return nullptr;
+    return dynamic_cast<ConvolutionProcessor*>(wrapper->processor.get());
+}
+
+int pedalboard_convolution_load_impulse_response(PedalboardProcessor processor, const char* path) {
+    pedalboard_init();
+    auto* convolution = getConvolutionProcessor(processor);
+    if (convolution == nullptr || path == nullptr) return 0;
+
+    juce::File file(path);
+    const auto key = "file:" + file.getFullPathName() + ":" + juce::String(file.getLastModificationTime().toMilliseconds());
+    if (auto shared = findImpulseResponse(key)) {
+        convolution->setImpulseResponse(std::move(shared));
+        return 1;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader(g_internal->getFormatManager().createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->lengthInSamples > std::numeric_limits<int>::max()) return 0;
+
+    auto ir = std::make_shared<ImpulseResponse>();
+    ir->samples.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+    ir->sampleRate = reader->sampleRate;
+    ir->key = key;
+    if (!reader->read(&ir->samples, 0, ir->samples.getNumSamples(), 0, true, true)) return 0;
+
+    convolution->setImpulseResponse(shareImpulseResponse(std::move(ir)));
+    return 1;
+}
+
+int pedalboard_convolution_set_impulse_response(PedalboardProcessor processor, const float* const* data, int num_channels, int num_samples, double sample_rate) {
+    pedalboard_init();
+    auto* convolution = getConvolutionProcessor(processor);
+    if (convolution == nullptr || data == nullptr || num_channels <= 0 || num_samples <= 0 || sample_rate <= 0.0) return 0;
+
+    // Keyed by content, so equal IRs from memory share spectra
+    ContentHash hash;
+    hash.addDouble(sample_rate);
+    hash.addInt(num_channels);
+    hash.addInt(num_samples);
+    for (int ch = 0; ch < num_channels; ++ch) hash.add(data[ch], sizeof(float) * (size_t)num_samples);
+
+    const auto key = "data:" + hash.toString();
+    auto shared = findImpulseResponse(key);
+    if (shared == nullptr) {
+        auto ir = std::make_shared<ImpulseResponse>();
+        ir->samples.setSize(num_channels, num_samples);
+        for (int ch = 0; ch < num_channels; ++ch) ir->samples.copyFrom(ch, 0, data[ch], num_samples);
+        ir->sampleRate = sample_rate;
+        ir->key = key;
+        shared = shareImpulseResponse(std::move(ir));
+    }
+    convolution->setImpulseResponse(std::move(shared));
+    return 1;
+}
+
+int pedalboard_convolution_set_head_size(PedalboardProcessor processor, int num_samples) {
+    auto* convolution = getConvolutionProcessor(processor);
+    if (convolution == nullptr || num_samples < 0) return 0;
+    convolution->setHeadSize(num_samples);
+    return 1;
+}
+
+// --- Fused Chains ---
+// A fused chain runs a fixed sequence of internal processors as a single
+// processor. The stages are concrete members rather than AudioProcessor
+// pointers, so each stage's processAudio binds statically and can be
+// inlined. A block goes through every stage one chunk at a time, so the
+// samples stay in cache from the first stage to the last instead of the
+// whole buffer streaming through memory once per stage.
+// Parameters use one flat index: the first stage's, then the second's, and
+// so on. Only the presets in fusedChainPresets are compiled in; any other
+// combination uses a regular ChainProcessor.
+class FusedChainBase : public juce::AudioProcessor, private juce::AudioProcessorListener {
+public:
+    FusedChainBase()
+        : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
+                                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)) {}
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        for (auto* stage : stagePointers) {
+            prepareProcessor(*stage, sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+        }
+        updateLatency();
+    }
+
+    void releaseResources() override {
+        for (auto* stage : stagePointers) stage->releaseResources();
+    }
+
+    void reset() override {
+        for (auto* stage : stagePointers) stage->reset();
+    }
+
+    // Thread-safe, like BaseInternalProcessor::queueParam
+    void queueParam(int index, float value) {
+        for (auto* stage : stagePointers) {
+            const int numParams = stage->getNumParams();
+            if (index < numParams) {
+                stage->queueParam(index, value);
+                return;
+            }
+            index -= numParams;
+        }
+    }
+
+    float getQueuedParam(int index) const {
+        for (auto* stage : stagePointers) {
+            const int numParams = stage->getNumParams();
+            if (index < numParams) return stage->getQueuedParam(index);
+            index -= numParams;
+        }
+        return 0.0f;
+    }
+
+    int getNumParams() const {
+        int total = 0;
+        for (auto* stage : stagePointers) total += stage->getNumParams();
+        return total;
+    }
+
+    juce::StringArray getStageNames() const {
+        juce::StringArray names;
+        for (auto* stage : stagePointers) names.add(stage->getName());
+        return names;
+    }
+
+    const juce::String getName() const override { return "FusedChain"; }
+
+    // Same as a chain: each stage's tail and latency delay the next
+    double getTailLengthSeconds() const override {
+        double tail = 0.0;
+        for (auto* stage : stagePointers) {
+            tail += stage->getTailLengthSeconds();
+            if (stage->getSampleRate() > 0.0) tail += stage->getLatencySamples() / stage->getSampleRate();
+        }
+        return tail;
+    }
+
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    // State is each stage's state block, in order
+    void getStateInformation(juce::MemoryBlock& destData) override {
+        juce::MemoryOutputStream stream(destData, false);
+        stream.writeInt((int)stagePointers.size());
+        for (auto* stage : stagePointers) {
+            juce::MemoryBlock state;
+            stage->getStateInformation(state);
+            stream.writeInt((int)state.getSize());
+            stream.write(state.getData(), state.getSize());
+        }
+    }
+
+    void setStateInformation(const void* data, int sizeInBytes) override {
+        juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+        if (stream.readInt() != (int)stagePointers.size()) return;
+        for (auto* stage : stagePointers) {
+            juce::MemoryBlock state;
+            const int size = stream.readInt();
+            if (size < 0 || stream.readIntoMemoryBlock(state, size) != (size_t)size) return;
+            stage->setStateInformation(state.getData(), (int)state.getSize());
+        }
+    }
+
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+protected:
+    // Samples per channel each stage processes before handing on to the next
+    static constexpr int chunkSize = 256;
+
+    void addStage(BaseInternalProcessor& stage) {
+        stage.syncParamSlots();
+        stage.addListener(this);
+        stagePointers.push_back(&stage);
+    }
+
+    void removeStages() {
+        for (auto* stage : stagePointers) stage->removeListener(this);
+        stagePointers.clear();
+    }
+
+    std::vector<BaseInternalProcessor*> stagePointers; // Owned by the derived class, for the cold paths
+
+private:
+    // Stages such as Distortion change latency with their parameters, and
+    // report it from the setter's thread, so the audio thread never does
+    void updateLatency() {
+        int latency = 0;
+        for (auto* stage : stagePointers) latency += stage->getLatencySamples();
+        if (latency != getLatencySamples()) setLatencySamples(latency);
+    }
+
+    void audioProcessorChanged(juce::AudioProcessor*, const juce::AudioProcessorListener::ChangeDetails& details) override {
+        if (details.latencyChanged) updateLatency();
+    }
+
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override {}
+};
+
+} // extern "C"; templates need C++ linkage
+
+template <typename... Stages>
+class FusedChain final : public FusedChainBase {
+public:
+    FusedChain() {
+        std::apply([this](auto&... stage) { (addStage(stage), ...); }, stages);
+    }
+
+    // The stages are members, so they go before the base's destructor runs
+    ~FusedChain() override { removeStages(); }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+        std::apply([](auto&... stage) { (stage.applyPendingParams(), ...); }, stages);
+
+        const int numChannels = buffer.getNumChannels();
+        float* const* channelData = buffer.getArrayOfWritePointers();
+        for (int start = 0; start < buffer.getNumSamples(); start += chunkSize) {
+            // Refers to the caller's samples rather than copying them
+            juce::AudioBuffer<float> chunk(channelData, numChannels, start, juce::jmin(chunkSize, buffer.getNumSamples() - start));
+            std::apply([&chunk](auto&... stage) { (processStage(stage, chunk), ...); }, stages);
+        }
+    }
+
+private:
+    // The qualified call binds statically, so it can be inlined
+    template <typename Stage>
+    static void processStage(Stage& stage, juce::AudioBuffer<float>& chunk) {
+        stage.Stage::processAudio(chunk);
+    }
+
+    std::tuple<Stages...> stages;
+};
+
+// Filter stages need their type at construction
+struct LowPassStage : FilterProcessor { LowPassStage() : FilterProcessor(LowPass) {} };
+struct HighPassStage : FilterProcessor { HighPassStage() : FilterProcessor(HighPass) {} };
+
+template <typename... Stages>
+static std::unique_ptr<FusedChainBase> makeFusedChain() {
+    return std::make_unique<FusedChain<Stages...>>();
+}
+
+// Common all-internal boards. Stage names are as createInternalProcessor takes them.
+struct FusedChainPreset {
+    static constexpr int maxStages = 4;
+    const char* stages[maxStages];
+    std::unique_ptr<FusedChainBase> (*create)();
+};
+
+static const FusedChainPreset fusedChainPresets[] = {
+    { { "Gain", "Limiter" }, makeFusedChain<GainProcessor, LimiterProcessor> },
+    { { "Compressor", "Limiter" }, makeFusedChain<CompressorProcessor, LimiterProcessor> },
+    { { "HighPass", "Compressor", "Gain" }, makeFusedChain<HighPassStage, CompressorProcessor, GainProcessor> },
+    { { "HighPass", "Compressor", "Limiter" }, makeFusedChain<HighPassStage, CompressorProcessor, LimiterProcessor> },
+    { { "Distortion", "LowPass", "Reverb" }, makeFusedChain<DistortionProcessor, LowPassStage, ReverbProcessor> },
+    { { "Compressor", "Distortion", "Delay", "Reverb" }, makeFusedChain<CompressorProcessor, DistortionProcessor, DelayProcessor, ReverbProcessor> },
+    { { "Chorus", "Delay", "Reverb" }, makeFusedChain<ChorusProcessor, DelayProcessor, ReverbProcessor> },
+};
+
+static int getNumStages(const FusedChainPreset& preset) {
+    int count = 0;
+    while (count < FusedChainPreset::maxStages && preset.stages[count] != nullptr) ++count;
+    return count;
+}
+
+static std::unique_ptr<FusedChainBase> createFusedChain(const juce::StringArray& names) {
+    for (const auto& preset : fusedChainPresets) {
+        if (getNumStages(preset) != names.size()) continue;
+        bool matches = true;
+        for (int i = 0; i < names.size() && matches; ++i) matches = names[i] == preset.stages[i];
+        if (matches) return preset.create();
+    }
+    return nullptr;
+}
+
+extern "C" {
+
+int pedalboard_get_num_fused_chain_presets() {
+    return (int)(sizeof(fusedChainPresets) / sizeof(fusedChainPresets[0]));
+}
+
+int pedalboard_get_fused_chain_preset(int index, const char** names, int max_names) {
+    if (index < 0 || index >= pedalboard_get_num_fused_chain_presets()) return 0;
+    const auto& preset = fusedChainPresets[index];
+    const int count = getNumStages(preset);
+    for (int i = 0; i < juce::jmin(count, max_names); ++i) names[i] = preset.stages[i];
+    return count;
+}
+
+PedalboardProcessor pedalboard_create_fused_chain(const char** names, int num_names) {
+    if (names == nullptr || num_names <= 0) return nullptr;
+    juce::StringArray stageNames;
+    for (int i = 0; i < num_names; ++i) {
+        if (names[i] == nullptr) return nullptr;
+        stageNames.add(juce::String(names[i]));
+    }
+
+    auto fused = createFusedChain(stageNames);
+    if (fused == nullptr) return nullptr;
+
+    auto wrapper = new ProcessorWrapper();
+    wrapper->processor = std::move(fused);
+    wrapper->kind = ProcessorWrapper::Kind::fused;
+    return static_cast<PedalboardProcessor>(wrapper);
+}
+
+// ... Rest of the file (LoadPlugin, AudioIO, Stream) ...
+
+PedalboardProcessor pedalboard_load_plugin(const char* path) {
+    pedalboard_init();
+    juce::OwnedArray<juce::PluginDescription> descriptions;
+    g_internal->findPluginTypes(juce::File(path).getFullPathName(), descriptions);
+    
+    if (descriptions.size() == 0) return nullptr;
     
-    // Simplified prepare call if rate changes
-    if (wrapper->processor->getSampleRate() != sample_rate) {
-        wrapper->processor->prepareToPlay(sample_rate, num_samples);
+    juce::String error;
+    auto plugin = g_internal->getPluginFormatManager().createPluginInstance(*descriptions[0], 44100.0, 512, error);
+    if (plugin == nullptr) return nullptr;
+    
+    auto wrapper = new ProcessorWrapper();
+    wrapper->processor = std::move(plugin);
+    wrapper->pluginDescription = std::make_unique<juce::PluginDescription>(*descriptions[0]);
+    return static_cast<PedalboardProcessor>(wrapper);
+}
+
+int pedalboard_set_plugin_cache_file(const char* path) {
+    pedalboard_init();
+    return g_internal->setPluginCacheFile(juce::File(path)) ? 1 : 0;
+}
+
+int pedalboard_scan_plugins(const char* directory) {
+    pedalboard_init();
+    juce::File dir(directory);
+    if (!dir.isDirectory()) return 0;
+
+    for (int i = 0; i < g_internal->getPluginFormatManager().getNumFormats(); ++i) {
+        auto* format = g_internal->getPluginFormatManager().getFormat(i);
+        juce::PluginDirectoryScanner scanner(g_internal->knownPlugins, *format, juce::FileSearchPath(dir.getFullPathName()), true, juce::File());
+        juce::String pluginBeingScanned;
+        while (scanner.scanNextFile(true, pluginBeingScanned)) {}
+    }
+    g_internal->savePluginCache();
+
+    int numFound = 0;
+    for (auto& desc : g_internal->knownPlugins.getTypes()) {
+        if (juce::File(desc.fileOrIdentifier).isAChildOf(dir)) ++numFound;
+    }
+    return numFound;
+}
+
+PedalboardAudioBuffer* pedalboard_audio_buffer_create(int num_channels, int num_samples, double sample_rate) {
+    if (num_channels <= 0 || num_samples < 0) return nullptr;
+
+    auto* channels = (float**)malloc(sizeof(float*) * (size_t)num_channels);
+    auto* block = (float*)calloc((size_t)num_channels * (size_t)juce::jmax(1, num_samples), sizeof(float));
+    if (channels == nullptr || block == nullptr) {
+        free(channels);
+        free(block);
+        return nullptr;
+    }
+
+    for (int i = 0; i < num_channels; ++i) {
+        channels[i] = block + (size_t)i * (size_t)num_samples;
+    }
+
+    auto* result = new PedalboardAudioBuffer();
+    result->data = channels;
+    result->num_channels = num_channels;
+    result->num_samples = num_samples;
+    result->sample_rate = sample_rate;
+    return result;
+}
+
+PedalboardAudioBuffer* pedalboard_load_audio_file(const char* path) {
+    pedalboard_init();
+    juce::File file(path);
+    std::unique_ptr<juce::AudioFormatReader> reader(g_internal->getFormatManager().createReaderFor(file));
+    if (reader == nullptr) return nullptr;
+    if (reader->lengthInSamples > std::numeric_limits<int>::max()) return nullptr;
+
+    auto* result = pedalboard_audio_buffer_create((int)reader->numChannels, (int)reader->lengthInSamples, reader->sampleRate);
+    if (result == nullptr) return nullptr;
+
+    juce::AudioBuffer<float> tempBuffer(result->data, result->num_channels, result->num_samples);
+    reader->read(&tempBuffer, 0, result->num_samples, 0, true, true);
+    return result;
+}
+
+// A writer into a temporary file beside the target. commit() finishes the
+// file and moves it over the target, so a failed open or an abandoned write
+// leaves any existing file untouched; otherwise the temporary file is
+// deleted with this.
+struct FileWriter {
+    bool commit() {
+        writer.reset(); // Flushes and closes the temporary file
+        return temporaryFile->overwriteTargetFileWithTemporary();
+    }
+
+    std::unique_ptr<juce::TemporaryFile> temporaryFile;
+    std::unique_ptr<juce::AudioFormatWriter> writer; // May be handed on, and deleted, before commit()
+};
+
+// The format comes from the target's extension; bitsPerSample must be a
+// depth the format supports. Returns nullptr if the writer can't be created.
+static std::unique_ptr<FileWriter> createFileWriter(const juce::File& file, double sampleRate, int numChannels, int bitsPerSample, int qualityIndex) {
+    auto* format = g_internal->getFormatManager().findFormatForFileExtension(file.getFileExtension());
+    if (format == nullptr) format = g_internal->getFormatManager().getDefaultFormat();
+    if (format == nullptr || !format->getPossibleBitDepths().contains(bitsPerSample)) return nullptr;
+
+    const int numQualityOptions = format->getQualityOptions().size();
+    if (qualityIndex < 0 || (numQualityOptions > 0 && qualityIndex >= numQualityOptions)) return nullptr;
+
+    auto result = std::make_unique<FileWriter>();
+    result->temporaryFile = std::make_unique<juce::TemporaryFile>(file, juce::TemporaryFile::useHiddenFile);
+    std::unique_ptr<juce::FileOutputStream> stream(result->temporaryFile->getFile().createOutputStream());
+    if (stream == nullptr || stream->failedToOpen()) return nullptr;
+
+    result->writer.reset(format->createWriterFor(stream.get(),
+                                                 sampleRate,
+                                                 (unsigned int)numChannels,
+                                                 bitsPerSample,
+                                                 {},
+                                                 qualityIndex));
+    if (result->writer == nullptr) return nullptr; // E.g. a channel count or rate the format can't store
+    stream.release(); // Now owned by the writer
+    return result;
+}
+
+static int optionBitsPerSample(const PedalboardAudioWriterOptions* options) {
+    return options != nullptr && options->bits_per_sample > 0 ? options->bits_per_sample : 16;
+}
+
+void pedalboard_save_audio_file(const char* path, PedalboardAudioBuffer* buffer) {
+    pedalboard_save_audio_file_with_options(path, buffer, nullptr);
+}
+
+int pedalboard_save_audio_file_with_options(const char* path, PedalboardAudioBuffer* buffer, const PedalboardAudioWriterOptions* options) {
+    if (path == nullptr || buffer == nullptr || buffer->num_channels <= 0) return 0;
+    pedalboard_init();
+
+    auto file = createFileWriter(juce::File(path), buffer->sample_rate, buffer->num_channels,
+                                 optionBitsPerSample(options), options != nullptr ? options->quality : 0);
+    if (file == nullptr) return 0;
+    if (!file->writer->writeFromFloatArrays(buffer->data, buffer->num_channels, buffer->num_samples)) return 0;
+    return file->commit() ? 1 : 0;
+}
+
+void pedalboard_audio_buffer_free(PedalboardAudioBuffer* buffer) {
+    if (buffer == nullptr) return;
+    // All channels share the block starting at data[0]
+    free(buffer->data[0]);
+    free(buffer->data);
+    delete buffer;
+}
+
+// --- Compact Buffers ---
+// 16-bit planar buffers for large in-memory corpora. Processing decodes one
+// block at a time into float, runs the processor and encodes the result
+// back, so only a block's worth of float audio ever exists. The int16 loops
+// are plain arithmetic the compiler vectorises; half floats decode through
+// a table and encode with IEEE round-to-nearest-even.
+static constexpr int compactBlockSize = 4096;
+
+static float halfToFloatSlow(juce::uint16 half) {
+    const juce::uint32 sign = (juce::uint32)(half & 0x8000u) << 16;
+    const juce::uint32 exponent = (half >> 10) & 0x1fu;
+    const juce::uint32 mantissa = half & 0x3ffu;
+
+    if (exponent == 0) {
+        // Zero or subnormal: mantissa * 2^-24
+        const float magnitude = (float)mantissa * (1.0f / 16777216.0f);
+        return sign != 0 ? -magnitude : magnitude;
+    }
+    const juce::uint32 bits = exponent == 31 ? sign | 0x7f800000u | (mantissa << 13)
+                                             : sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static const float* getHalfToFloatTable() {
+    static std::vector<float> table;
+    static std::once_flag built;
+    std::call_once(built, [] {
+        table.resize(65536);
+        for (juce::uint32 i = 0; i < 65536; ++i) table[i] = halfToFloatSlow((juce::uint16)i);
+    });
+    return table.data();
+}
+
+static juce::uint16 floatToHalf(float value) {
+    juce::uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const auto sign = (juce::uint16)((bits >> 16) & 0x8000u);
+    const juce::uint32 magnitude = bits & 0x7fffffffu;
+
+    if (magnitude > 0x7f800000u) return (juce::uint16)(sign | 0x7e00u);  // NaN
+    if (magnitude >= 0x477ff000u) return (juce::uint16)(sign | 0x7c00u); // Rounds past 65504 to infinity
+    if (magnitude < 0x38800000u) {
+        // Below the smallest normal half: a subnormal in units of 2^-24
+        float scaled;
+        std::memcpy(&scaled, &magnitude, sizeof(scaled));
+        return (juce::uint16)(sign | (juce::uint16)std::nearbyint(scaled * 16777216.0f));
+    }
+    // Rebias the exponent and round the mantissa to nearest even
+    const juce::uint32 rebiased = magnitude - 0x38000000u;
+    return (juce::uint16)(sign | ((rebiased + 0xfffu + ((rebiased >> 13) & 1u)) >> 13));
+}
+
+static bool isCompactFormat(int format) {
+    return format == PEDALBOARD_SAMPLE_INT16 || format == PEDALBOARD_SAMPLE_FLOAT16;
+}
+
+static juce::uint16* getCompactChannel(const PedalboardCompactAudioBuffer& buffer, int channel) {
+    return static_cast<juce::uint16*>(buffer.data) + (size_t)channel * (size_t)buffer.num_samples;
+}
+
+static void decodeCompact(const PedalboardCompactAudioBuffer& buffer, int channel, float* dest, int start, int count) {
+    const juce::uint16* source = getCompactChannel(buffer, channel) + start;
+    if (buffer.format == PEDALBOARD_SAMPLE_INT16) {
+        const auto* samples = reinterpret_cast<const juce::int16*>(source);
+        for (int i = 0; i < count; ++i) dest[i] = (float)samples[i] * (1.0f / 32768.0f);
+    } else {
+        const float* table = getHalfToFloatTable();
+        for (int i = 0; i < count; ++i) dest[i] = table[source[i]];
+    }
+}
+
+static void encodeCompact(PedalboardCompactAudioBuffer& buffer, int channel, const float* source, int start, int count) {
+    juce::uint16* dest = getCompactChannel(buffer, channel) + start;
+    if (buffer.format == PEDALBOARD_SAMPLE_INT16) {
+        auto* samples = reinterpret_cast<juce::int16*>(dest);
+        for (int i = 0; i < count; ++i) {
+            // Clipped rather than wrapped; rounded half away from zero
+            const float scaled = juce::jlimit(-32768.0f, 32767.0f, source[i] * 32768.0f);
+            samples[i] = (juce::int16)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+        }
+    } else {
+        for (int i = 0; i < count; ++i) dest[i] = floatToHalf(source[i]);
+    }
+}
+
+PedalboardCompactAudioBuffer* pedalboard_compact_buffer_create(int format, int num_channels, int num_samples, double sample_rate) {
+    if (!isCompactFormat(format) || num_channels <= 0 || num_samples < 0) return nullptr;
+
+    void* block = calloc((size_t)num_channels * (size_t)juce::jmax(1, num_samples), sizeof(juce::uint16));
+    if (block == nullptr) return nullptr;
+
+    auto* result = new PedalboardCompactAudioBuffer();
+    result->data = block;
+    result->format = format;
+    result->num_channels = num_channels;
+    result->num_samples = num_samples;
+    result->sample_rate = sample_rate;
+    return result;
+}
+
+void pedalboard_compact_buffer_free(PedalboardCompactAudioBuffer* buffer) {
+    if (buffer == nullptr) return;
+    free(buffer->data);
+    delete buffer;
+}
+
+PedalboardCompactAudioBuffer* pedalboard_load_audio_file_compact(const char* path, int format) {
+    pedalboard_init();
+    if (path == nullptr || !isCompactFormat(format)) return nullptr;
+    std::unique_ptr<juce::AudioFormatReader> reader(g_internal->getFormatManager().createReaderFor(juce::File(path)));
+    if (reader == nullptr) return nullptr;
+    if (reader->lengthInSamples > std::numeric_limits<int>::max()) return nullptr;
+
+    auto* result = pedalboard_compact_buffer_create(format, (int)reader->numChannels, (int)reader->lengthInSamples, reader->sampleRate);
+    if (result == nullptr) return nullptr;
+
+    // Decoded a block at a time, so the file is never held as float
+    juce::AudioBuffer<float> block(result->num_channels, compactBlockSize);
+    for (int start = 0; start < result->num_samples; start += compactBlockSize) {
+        const int count = juce::jmin(compactBlockSize, result->num_samples - start);
+        reader->read(&block, 0, count, start, true, true);
+        for (int ch = 0; ch < result->num_channels; ++ch) encodeCompact(*result, ch, block.getReadPointer(ch), start, count);
+    }
+    return result;
+}
+
+int pedalboard_compact_buffer_read(const PedalboardCompactAudioBuffer* buffer, float** samples, int num_channels, int start, int num_samples) {
+    if (buffer == nullptr || samples == nullptr || num_channels > buffer->num_channels) return 0;
+    if (start < 0 || num_samples < 0 || start > buffer->num_samples - num_samples) return 0;
+    for (int ch = 0; ch < num_channels; ++ch) decodeCompact(*buffer, ch, samples[ch], start, num_samples);
+    return 1;
+}
+
+int pedalboard_compact_buffer_write(PedalboardCompactAudioBuffer* buffer, const float* const* samples, int num_channels, int start, int num_samples) {
+    if (buffer == nullptr || samples == nullptr || num_channels > buffer->num_channels) return 0;
+    if (start < 0 || num_samples < 0 || start > buffer->num_samples - num_samples) return 0;
+    for (int ch = 0; ch < num_channels; ++ch) encodeCompact(*buffer, ch, samples[ch], start, num_samples);
+    return 1;
+}
+
+void pedalboard_processor_process_compact(PedalboardProcessor processor, PedalboardCompactAudioBuffer* buffer) {
+    if (!processor || buffer == nullptr || buffer->num_samples <= 0) return;
+    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
+    const int numChannels = buffer->num_channels;
+
+    juce::AudioBuffer<float> block(numChannels, compactBlockSize);
+    for (int start = 0; start < buffer->num_samples; start += compactBlockSize) {
+        const int count = juce::jmin(compactBlockSize, buffer->num_samples - start);
+        for (int ch = 0; ch < numChannels; ++ch) decodeCompact(*buffer, ch, block.getWritePointer(ch), start, count);
+        processWrapper(wrapper, block.getArrayOfWritePointers(), numChannels, count, buffer->sample_rate);
+        for (int ch = 0; ch < numChannels; ++ch) encodeCompact(*buffer, ch, block.getReadPointer(ch), start, count);
+    }
+}
+
+// --- Sample Rate Conversion ---
+// Converts a continuous multi-channel stream between two rates with a
+// windowed-sinc interpolator per channel. Input is pushed in any amount up to
+// the prepared block size, and output is pulled as far as the buffered input
+// allows. The interpolator doesn't band-limit, so when converting down the
+// input first goes through a Butterworth low-pass below the target Nyquist.
+class StreamingResampler {
+public:
+    void prepare(double sourceRate, double targetRate, int numChannels, int maxInputBlock) {
+        ratio = sourceRate / targetRate;
+        channels = numChannels;
+        pending.setSize(numChannels, maxInputBlock + (int)std::ceil(ratio) + 16);
+        discard.setSize(1, maxOutputFor(maxInputBlock));
+        interpolators.assign((size_t)numChannels, juce::WindowedSincInterpolator());
+
+        antiAliasing.clear();
+        sectionsPerChannel = 0;
+        if (targetRate < sourceRate) {
+            auto coefficients = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod((float)(targetRate * 0.45), sourceRate, 8);
+            sectionsPerChannel = coefficients.size();
+            for (int ch = 0; ch < numChannels; ++ch) {
+                for (auto* section : coefficients) antiAliasing.emplace_back(section);
+            }
+        }
+        reset();
+    }
+
+    void reset() {
+        pending.clear();
+        pendingCount = 0;
+        for (auto& interpolator : interpolators) interpolator.reset();
+        for (auto& filter : antiAliasing) filter.reset();
+    }
+
+    // Appends numSamples per channel; channels beyond numInputChannels are
+    // silent. Returns how many were taken: pending holds the prepared block
+    // plus what pull leaves behind, so anything less means the caller pushed
+    // more than it prepared for, or pushed twice without pulling.
+    int push(const float* const* input, int numInputChannels, int numSamples) {
+        const int accepted = juce::jlimit(0, numSamples, pending.getNumSamples() - pendingCount);
+        jassert(accepted == numSamples);
+        numSamples = accepted;
+        if (numSamples <= 0) return 0;
+
+        for (int ch = 0; ch < channels; ++ch) {
+            float* dest = pending.getWritePointer(ch, pendingCount);
+            if (input != nullptr && ch < numInputChannels) {
+                juce::FloatVectorOperations::copy(dest, input[ch], numSamples);
+            } else {
+                juce::FloatVectorOperations::clear(dest, numSamples);
+            }
+            for (int s = 0; s < sectionsPerChannel; ++s) {
+                auto& filter = antiAliasing[(size_t)(ch * sectionsPerChannel + s)];
+                for (int i = 0; i < numSamples; ++i) dest[i] = filter.processSample(dest[i]);
+            }
+        }
+        pendingCount += numSamples;
+        return numSamples;
+    }
+
+    int pushSilence(int numSamples) { return push(nullptr, 0, numSamples); }
+
+    // Produces up to maxOutput samples per channel and returns how many were
+    // produced. Channels beyond numOutputChannels are computed and dropped.
+    int pull(float* const* output, int numOutputChannels, int maxOutput) {
+        // Every output advances the read position by ratio; keep a spare
+        // input so the interpolator never runs past what has been pushed
+        const int available = (int)std::floor((pendingCount - 2) / ratio);
+        const int count = juce::jlimit(0, juce::jmin(maxOutput, discard.getNumSamples()), available);
+        if (count == 0) return 0;
+
+        int used = 0;
+        for (int ch = 0; ch < channels; ++ch) {
+            float* dest = ch < numOutputChannels ? output[ch] : discard.getWritePointer(0);
+            used = interpolators[(size_t)ch].process(ratio, pending.getReadPointer(ch), dest, count);
+        }
+
+        const int remaining = pendingCount - used;
+        for (int ch = 0; ch < channels; ++ch) {
+            float* data = pending.getWritePointer(ch);
+            std::memmove(data, data + used, sizeof(float) * (size_t)remaining);
+        }
+        pendingCount = remaining;
+        return count;
+    }
+
+    // Upper bound on what pull can return after pushing numInput samples.
+    int maxOutputFor(int numInput) const {
+        return (int)std::ceil((numInput + std::ceil(ratio) + 16) / ratio) + 1;
+    }
+
+    // Algorithmic delay, in source samples.
+    static double getLatency() { return (double)juce::WindowedSincInterpolator::getBaseLatency(); }
+
+    double getRatio() const { return ratio; }
+
+private:
+    double ratio = 1.0;
+    int channels = 0;
+    juce::AudioBuffer<float> pending;
+    int pendingCount = 0;
+    juce::AudioBuffer<float> discard;
+    std::vector<juce::WindowedSincInterpolator> interpolators;
+    std::vector<juce::dsp::IIR::Filter<float>> antiAliasing;
+    int sectionsPerChannel = 0;
+};
+
+// --- Streaming Audio File IO ---
+struct AudioReaderInternal {
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::int64 position = 0; // In output samples
+    bool mapped = false; // reader is a MemoryMappedAudioFormatReader over the whole file
+
+    // Set when the file is converted to outputRate while it is read
+    std::unique_ptr<StreamingResampler> resampler;
+    double outputRate = 0.0;
+    juce::int64 outputLength = 0;
+    juce::int64 sourcePosition = 0;
+    int latencyToSkip = 0;
+    juce::AudioBuffer<float> sourceBlock;
+    std::vector<float*> outputChannels;
+
+    static constexpr int sourceBlockSize = 4096;
+
+    juce::int64 getLength() const { return resampler != nullptr ? outputLength : reader->lengthInSamples; }
+
+    // Restarts conversion at an output position, dropping the interpolator's
+    // delay so output sample 0 lines up with source sample 0.
+    void restartResampler() {
+        resampler->reset();
+        sourcePosition = (juce::int64)std::floor((double)position * resampler->getRatio());
+        latencyToSkip = juce::roundToInt(StreamingResampler::getLatency() / resampler->getRatio());
+    }
+
+    int readResampled(float** samples, int numChannels, int numSamples) {
+        const int fileChannels = (int)reader->numChannels;
+        int produced = 0;
+        while (produced < numSamples) {
+            int count;
+            if (latencyToSkip > 0) {
+                count = resampler->pull(nullptr, 0, latencyToSkip);
+                latencyToSkip -= count;
+            } else {
+                const int channels = juce::jmin(numChannels, fileChannels);
+                for (int ch = 0; ch < channels; ++ch) outputChannels[(size_t)ch] = samples[ch] + produced;
+                count = resampler->pull(outputChannels.data(), channels, numSamples - produced);
+                produced += count;
+            }
+            if (count > 0) continue;
+
+            // Past the end the reader fills with silence, which flushes the tail
+            if (!reader->read(&sourceBlock, 0, sourceBlockSize, sourcePosition, true, true)) break;
+            sourcePosition += sourceBlockSize;
+            // pull has drained pending, so the whole block always fits
+            if (resampler->push(sourceBlock.getArrayOfReadPointers(), fileChannels, sourceBlockSize) == 0) break;
+        }
+
+        for (int ch = fileChannels; ch < numChannels; ++ch) {
+            juce::FloatVectorOperations::clear(samples[ch], produced);
+        }
+        return produced;
+    }
+};
+
+struct AudioWriterInternal {
+    ~AudioWriterInternal() { close(); }
+
+    // Finishes the file, waiting for a threaded writer's queue, and only
+    // then moves it into place. Returns false if it couldn't be moved.
+    bool close() {
+        threaded.reset();
+        const auto finished = std::move(file);
+        return finished == nullptr || finished->commit();
+    }
+
+    std::unique_ptr<FileWriter> file;                                  // Writes synchronously unless threaded
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> threaded; // Background writers
+    int numChannels = 0;
+    int maxChunk = 0;                 // Largest write that fits in the background FIFO
+    std::vector<const float*> chunk;  // Channel pointers for one chunk of a larger write
+};
+
+PedalboardAudioReader pedalboard_audio_reader_open(const char* path) {
+    pedalboard_init();
+    juce::File file(path);
+    std::unique_ptr<juce::AudioFormatReader> reader(g_internal->getFormatManager().createReaderFor(file));
+    if (reader == nullptr) return nullptr;
+
+    auto* result = new AudioReaderInternal();
+    result->reader = std::move(reader);
+    return static_cast<PedalboardAudioReader>(result);
+}
+
+PedalboardAudioReader pedalboard_audio_reader_open_mapped(const char* path) {
+    pedalboard_init();
+    juce::File file(path);
+
+    // Only uncompressed formats (WAV, AIFF) can be read straight from a mapping
+    if (auto* format = g_internal->getFormatManager().findFormatForFileExtension(file.getFileExtension())) {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader(format->createMemoryMappedReader(file));
+        // Mapping reserves address space only; pages are read, and shared
+        // through the page cache, as the samples are touched
+        if (reader != nullptr && reader->mapEntireFile()) {
+            auto* result = new AudioReaderInternal();
+            result->reader = std::move(reader);
+            result->mapped = true;
+            return static_cast<PedalboardAudioReader>(result);
+        }
+    }
+    return pedalboard_audio_reader_open(path);
+}
+
+PedalboardAudioReader pedalboard_audio_reader_open_resampled(const char* path, double sample_rate) {
+    if (sample_rate <= 0) return nullptr;
+    auto* handle = pedalboard_audio_reader_open(path);
+    if (handle == nullptr) return nullptr;
+
+    auto* internal = static_cast<AudioReaderInternal*>(handle);
+    const double sourceRate = internal->reader->sampleRate;
+    if (sourceRate <= 0 || sourceRate == sample_rate) return handle;
+
+    const int numChannels = (int)internal->reader->numChannels;
+    internal->resampler = std::make_unique<StreamingResampler>();
+    internal->resampler->prepare(sourceRate, sample_rate, numChannels, AudioReaderInternal::sourceBlockSize);
+    internal->outputRate = sample_rate;
+    internal->outputLength = (juce::int64)std::ceil((double)internal->reader->lengthInSamples * sample_rate / sourceRate);
+    internal->sourceBlock.setSize(numChannels, AudioReaderInternal::sourceBlockSize);
+    internal->outputChannels.resize((size_t)numChannels);
+    internal->restartResampler();
+    return handle;
+}
+
+int pedalboard_audio_reader_is_mapped(PedalboardAudioReader reader) {
+    if (!reader) return 0;
+    return static_cast<AudioReaderInternal*>(reader)->mapped ? 1 : 0;
+}
+
+void pedalboard_audio_reader_get_info(PedalboardAudioReader reader, PedalboardAudioFileInfo* info) {
+    if (!reader || !info) return;
+    auto* internal = static_cast<AudioReaderInternal*>(reader);
+    info->num_channels = (int)internal->reader->numChannels;
+    info->num_samples = (int64_t)internal->getLength();
+    info->sample_rate = internal->resampler != nullptr ? internal->outputRate : internal->reader->sampleRate;
+    info->bits_per_sample = (int)internal->reader->bitsPerSample;
+}
+
+int pedalboard_audio_reader_read(PedalboardAudioReader reader, float** samples, int num_channels, int num_samples) {
+    if (!reader || !samples || num_channels <= 0 || num_samples <= 0) return 0;
+    auto* internal = static_cast<AudioReaderInternal*>(reader);
+
+    auto remaining = internal->getLength() - internal->position;
+    int numToRead = (int)juce::jmin((juce::int64)num_samples, remaining);
+    if (numToRead <= 0) return 0;
+
+    if (internal->resampler != nullptr) {
+        if ((size_t)num_channels > internal->outputChannels.size()) return 0;
+        const int numRead = internal->readResampled(samples, num_channels, numToRead);
+        internal->position += numRead;
+        return numRead;
+    }
+
+    juce::AudioBuffer<float> dest(samples, num_channels, numToRead);
+    if (!internal->reader->read(&dest, 0, numToRead, internal->position, true, true)) return 0;
+
+    internal->position += numToRead;
+    return numToRead;
+}
+
+int pedalboard_audio_reader_seek(PedalboardAudioReader reader, int64_t position) {
+    if (!reader) return 0;
+    auto* internal = static_cast<AudioReaderInternal*>(reader);
+    if (position < 0 || position > internal->getLength()) return 0;
+    internal->position = position;
+    if (internal->resampler != nullptr) internal->restartResampler();
+    return 1;
+}
+
+int64_t pedalboard_audio_reader_get_position(PedalboardAudioReader reader) {
+    if (!reader) return 0;
+    return (int64_t)static_cast<AudioReaderInternal*>(reader)->position;
+}
+
+void pedalboard_audio_reader_close(PedalboardAudioReader reader) {
+    if (reader) delete static_cast<AudioReaderInternal*>(reader);
+}
+
+PedalboardAudioWriter pedalboard_audio_writer_open(const char* path, double sample_rate, int num_channels, int bits_per_sample) {
+    PedalboardAudioWriterOptions options = {};
+    options.bits_per_sample = bits_per_sample;
+    return pedalboard_audio_writer_open_with_options(path, sample_rate, num_channels, &options);
+}
+
+PedalboardAudioWriter pedalboard_audio_writer_open_with_options(const char* path, double sample_rate, int num_channels, const PedalboardAudioWriterOptions* options) {
+    if (path == nullptr || num_channels <= 0) return nullptr;
+    pedalboard_init();
+
+    auto file = createFileWriter(juce::File(path), sample_rate, num_channels,
+                                 optionBitsPerSample(options), options != nullptr ? options->quality : 0);
+    if (file == nullptr) return nullptr;
+
+    auto result = std::make_unique<AudioWriterInternal>();
+    result->numChannels = num_channels;
+    if (options != nullptr && options->threaded) {
+        const int fifoSamples = options->buffer_samples > 0 ? options->buffer_samples : 1 << 16;
+        result->maxChunk = juce::jmax(1, fifoSamples / 2);
+        result->chunk.resize((size_t)num_channels);
+        result->threaded = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(file->writer.release(),
+                                                                                     g_internal->getWriterThread(),
+                                                                                     fifoSamples);
+    }
+    result->file = std::move(file);
+    return static_cast<PedalboardAudioWriter>(result.release());
+}
+
+int pedalboard_audio_writer_write(PedalboardAudioWriter writer, float** samples, int num_channels, int num_samples) {
+    if (!writer || !samples) return 0;
+    if (num_samples <= 0) return 1;
+    auto* internal = static_cast<AudioWriterInternal*>(writer);
+    if (num_channels < internal->numChannels) return 0;
+
+    if (internal->threaded == nullptr) {
+        return internal->file->writer->writeFromFloatArrays(samples, internal->numChannels, num_samples) ? 1 : 0;
+    }
+
+    // Queue in chunks the FIFO can hold. A full FIFO means the disk has
+    // fallen behind, so wait for the background thread rather than drop audio.
+    for (int start = 0; start < num_samples;) {
+        const int count = juce::jmin(internal->maxChunk, num_samples - start);
+        for (int ch = 0; ch < internal->numChannels; ++ch) internal->chunk[(size_t)ch] = samples[ch] + start;
+
+        if (internal->threaded->write(internal->chunk.data(), count)) {
+            start += count;
+        } else {
+            juce::Thread::sleep(1);
+        }
+    }
+    return 1;
+}
+
+int pedalboard_audio_writer_close(PedalboardAudioWriter writer) {
+    if (!writer) return 0;
+    std::unique_ptr<AudioWriterInternal> internal(static_cast<AudioWriterInternal*>(writer));
+    // A threaded writer blocks here until its queued audio is on disk
+    return internal->close() ? 1 : 0;
+}
+
+void pedalboard_processor_free(PedalboardProcessor processor) {
+    if (processor) delete static_cast<ProcessorWrapper*>(processor);
+}
+
+void pedalboard_processor_set_parameter(PedalboardProcessor processor, int index, float value) {
+    if (!processor) return;
+    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
+
+    if (wrapper->kind == ProcessorWrapper::Kind::internal) {
+        static_cast<BaseInternalProcessor*>(wrapper->processor.get())->queueParam(index, value);
+        return;
+    }
+    if (wrapper->kind == ProcessorWrapper::Kind::fused) {
+        static_cast<FusedChainBase*>(wrapper->processor.get())->queueParam(index, value);
+        return;
+    }
+
+    // External plugin
+    auto& params = wrapper->processor->getParameters();
+    if (index >= 0 && index < params.size()) {
+        params[index]->setValueNotifyingHost(value);
+    }
+}
+
+float pedalboard_processor_get_parameter(PedalboardProcessor processor, int index) {
+    if (!processor) return 0.0f;
+    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
+
+    if (wrapper->kind == ProcessorWrapper::Kind::internal) {
+        return static_cast<BaseInternalProcessor*>(wrapper->processor.get())->getQueuedParam(index);
+    }
+    if (wrapper->kind == ProcessorWrapper::Kind::fused) {
+        return static_cast<FusedChainBase*>(wrapper->processor.get())->getQueuedParam(index);
+    }
+
+    auto& params = wrapper->processor->getParameters();
+    if (index >= 0 && index < params.size()) {
+        return params[index]->getValue();
+    }
+    return 0.0f;
+}
+
+int pedalboard_processor_get_latency_samples(PedalboardProcessor processor) {
+    if (!processor) return 0;
+    return static_cast<ProcessorWrapper*>(processor)->processor->getLatencySamples();
+}
+
+int pedalboard_processor_get_num_parameters(PedalboardProcessor processor) {
+    if (!processor) return 0;
+    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
+
+    if (wrapper->kind == ProcessorWrapper::Kind::internal) {
+        return static_cast<BaseInternalProcessor*>(wrapper->processor.get())->getNumParams();
+    }
+    if (wrapper->kind == ProcessorWrapper::Kind::fused) {
+        return static_cast<FusedChainBase*>(wrapper->processor.get())->getNumParams();
+    }
+
+    return wrapper->processor->getParameters().size();
+}
+
+void pedalboard_processor_process(PedalboardProcessor processor, float** samples, int num_channels, int num_samples, double sample_rate) {
+    if (!processor) return;
+    processWrapper(static_cast<ProcessorWrapper*>(processor), samples, num_channels, num_samples, sample_rate);
+}
+
+// Splits the call at each event's offset and applies the event's value
+// before the sub-block starting there. Internal processors pick it up at
+// the start of that sub-block, ramping where they smooth the parameter;
+// plugins receive it as a host parameter change.
+static void processAutomated(ProcessorWrapper* wrapper, float* const* samples, int num_channels, int num_samples, double sample_rate,
+                             const PedalboardParameterEvent* events, int num_events) {
+    prepareForCall(wrapper, num_channels, num_samples, sample_rate);
+
+    int position = 0;
+    for (int i = 0; i < num_events; ++i) {
+        // Unsorted or out-of-range offsets are clamped, never reordered
+        const int offset = juce::jlimit(position, num_samples, events[i].sample_offset);
+        processSpan(wrapper, samples, num_channels, position, offset);
+        position = offset;
+        pedalboard_processor_set_parameter(wrapper, events[i].param_index, events[i].value);
+    }
+    processSpan(wrapper, samples, num_channels, position, num_samples);
+}
+
+void pedalboard_processor_process_automated(PedalboardProcessor processor, float** samples, int num_channels, int num_samples, double sample_rate,
+                                            const PedalboardParameterEvent* events, int num_events) {
+    if (!processor) return;
+    processAutomated(static_cast<ProcessorWrapper*>(processor), samples, num_channels, num_samples, sample_rate,
+                     events, events != nullptr ? num_events : 0);
+}
+
+void pedalboard_processor_get_stats(PedalboardProcessor processor, PedalboardProcessorStats* stats) {
+    if (!processor || !stats) return;
+    const auto& source = static_cast<ProcessorWrapper*>(processor)->stats;
+    stats->calls = source.calls.load(std::memory_order_relaxed);
+    stats->total_ns = ticksToNanoseconds(source.totalTicks.load(std::memory_order_relaxed));
+    stats->max_ns = ticksToNanoseconds(source.maxTicks.load(std::memory_order_relaxed));
+    stats->bypassed = source.bypassed.load(std::memory_order_relaxed);
+}
+
+void pedalboard_processor_reset_stats(PedalboardProcessor processor) {
+    if (processor) static_cast<ProcessorWrapper*>(processor)->stats.reset();
+}
+
+PedalboardAnalyzer pedalboard_analyzer_create(double sample_rate, int num_channels, int fft_size) {
+    if (sample_rate <= 0.0 || num_channels <= 0 || fft_size < 0) return nullptr;
+    return static_cast<PedalboardAnalyzer>(new Analyzer(sample_rate, num_channels, fft_size));
+}
+
+void pedalboard_analyzer_free(PedalboardAnalyzer analyzer) {
+    delete static_cast<Analyzer*>(analyzer);
+}
+
+void pedalboard_analyzer_reset(PedalboardAnalyzer analyzer) {
+    if (analyzer) static_cast<Analyzer*>(analyzer)->reset();
+}
+
+void pedalboard_analyzer_process(PedalboardAnalyzer analyzer, const float* const* samples, int num_channels, int num_samples) {
+    if (!analyzer || !samples || num_samples <= 0) return;
+    static_cast<Analyzer*>(analyzer)->process(samples, num_channels, num_samples);
+}
+
+void pedalboard_analyzer_get_results(PedalboardAnalyzer analyzer, PedalboardAnalysis* results) {
+    if (!analyzer || !results) return;
+    static_cast<Analyzer*>(analyzer)->getResults(*results);
+}
+
+int pedalboard_analyzer_get_spectrum(PedalboardAnalyzer analyzer, float* decibels, int max_bins) {
+    if (!analyzer) return 0;
+    return static_cast<Analyzer*>(analyzer)->getSpectrum(decibels, max_bins);
+}
+
+PedalboardAudioTap pedalboard_audio_tap_create(int num_channels, int capacity) {
+    if (num_channels <= 0 || capacity <= 0) return nullptr;
+    return static_cast<PedalboardAudioTap>(new AudioTap(num_channels, capacity));
+}
+
+void pedalboard_audio_tap_free(PedalboardAudioTap tap) {
+    delete static_cast<AudioTap*>(tap);
+}
+
+int pedalboard_audio_tap_read(PedalboardAudioTap tap, float** samples, int num_channels, int max_samples) {
+    if (!tap || !samples || max_samples <= 0) return 0;
+    return static_cast<AudioTap*>(tap)->pull(samples, num_channels, max_samples);
+}
+
+int pedalboard_audio_tap_get_num_available(PedalboardAudioTap tap) {
+    return tap ? static_cast<AudioTap*>(tap)->getNumReady() : 0;
+}
+
+int64_t pedalboard_audio_tap_get_num_dropped(PedalboardAudioTap tap) {
+    return tap ? static_cast<AudioTap*>(tap)->getNumDropped() : 0;
+}
+
+void pedalboard_processor_set_tap(PedalboardProcessor processor, PedalboardAudioTap tap) {
+    if (processor) static_cast<ProcessorWrapper*>(processor)->observers.setTap(static_cast<AudioTap*>(tap));
+}
+
+void pedalboard_processor_set_analyzer(PedalboardProcessor processor, PedalboardAnalyzer analyzer) {
+    if (processor) static_cast<ProcessorWrapper*>(processor)->observers.setAnalyzer(static_cast<Analyzer*>(analyzer));
+}
+
+int pedalboard_processor_prepare(PedalboardProcessor processor, double sample_rate, int max_block_size, int num_channels) {
+    if (!processor || sample_rate <= 0 || max_block_size <= 0 || num_channels < 0) return 0;
+    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
+    return prepareProcessor(*wrapper->processor, sample_rate, max_block_size, num_channels) ? 1 : 0;
+}
+
+// --- Processor Chain ---
+class ChainProcessor : public juce::AudioProcessor, private juce::AudioProcessorListener {
+public:
+    using ProcessorList = std::vector<ProcessorWrapper*>;
+
+    ChainProcessor()
+        : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
+                                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)) {}
+
+    ~ChainProcessor() override {
+        for (auto* wrapper : *processors) wrapper->processor->removeListener(this);
+    }
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        const juce::ScopedLock sl(chainLock);
+        for (auto* wrapper : *processors) {
+            prepareProcessor(*wrapper->processor, sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+        }
+        prepared = true;
+    }
+
+    void releaseResources() override {
+        const juce::ScopedLock sl(chainLock);
+        for (auto* wrapper : *processors) {
+            wrapper->processor->releaseResources();
+        }
+        prepared = false;
+    }
+
+    void reset() override {
+        const juce::ScopedLock sl(chainLock);
+        for (auto* wrapper : *processors) {
+            wrapper->processor->reset();
+        }
+    }
+
+    // Takes no locks: edits publish a new list and wait for this to finish with the old one
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+        const AudioThreadGuard::Scope scope(audioThread);
+        const auto& list = *activeList.load();
+        if (autoBypass.load(std::memory_order_relaxed)) {
+            for (auto* wrapper : list) {
+                wrapper->processBlockOrBypass(buffer);
+            }
+        } else {
+            for (auto* wrapper : list) {
+                wrapper->processBlock(buffer);
+            }
+        }
+    }
+
+    // When enabled, each processor is skipped while its input is silent and
+    // its tail has decayed. Thread-safe; takes effect on the next block.
+    void setAutoBypass(bool enabled) { autoBypass.store(enabled, std::memory_order_relaxed); }
+    bool getAutoBypass() const { return autoBypass.load(std::memory_order_relaxed); }
+
+    // Appends a processor the chain takes ownership of (used for clones).
+    void appendOwned(std::unique_ptr<ProcessorWrapper> wrapper) {
+        insert(size(), wrapper.get());
+        ownedProcessors.push_back(std::move(wrapper));
+    }
+
+    ProcessorList getProcessors() {
+        const juce::ScopedLock sl(chainLock);
+        return *processors;
+    }
+
+    bool insert(int index, ProcessorWrapper* wrapper) {
+        if (wrapper == nullptr || index < 0) return false;
+
+        // Prepare outside the lock so the audio thread isn't held up
+        auto& processor = *wrapper->processor;
+        if (prepared && (processor.getSampleRate() != getSampleRate()
+                         || processor.getBlockSize() < getBlockSize()
+                         || processor.getTotalNumOutputChannels() != getTotalNumOutputChannels())) {
+            prepareProcessor(processor, getSampleRate(), getBlockSize(), getTotalNumOutputChannels());
+        }
+
+        const juce::ScopedLock sl(chainLock);
+        if (index > (int)processors->size()) return false;
+        auto updated = *processors;
+        updated.insert(updated.begin() + index, wrapper);
+        publish(std::move(updated));
+        return true;
+    }
+
+    bool remove(int index) {
+        const juce::ScopedLock sl(chainLock);
+        if (index < 0 || index >= (int)processors->size()) return false;
+        auto updated = *processors;
+        updated.erase(updated.begin() + index);
+        publish(std::move(updated));
+        return true;
+    }
+
+    int size() {
+        const juce::ScopedLock sl(chainLock);
+        return (int)processors->size();
+    }
+
+    const juce::String getName() const override { return "Chain"; }
+
+    // Each processor's tail and latency delay the silence reaching the next.
+    // Lock-free, since auto-bypass asks for it from the audio thread.
+    double getTailLengthSeconds() const override {
+        const AudioThreadGuard::Scope scope(audioThread);
+        double tail = 0.0;
+        for (auto* wrapper : *activeList.load()) {
+            const auto& processor = *wrapper->processor;
+            tail += processor.getTailLengthSeconds();
+            if (processor.getSampleRate() > 0.0) tail += processor.getLatencySamples() / processor.getSampleRate();
+        }
+        return tail;
+    }
+
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    // State is each processor's name and state block, in chain order
+    void getStateInformation(juce::MemoryBlock& destData) override {
+        juce::MemoryOutputStream stream(destData, false);
+        auto snapshot = getProcessors();
+        stream.writeInt((int)snapshot.size());
+        for (auto* wrapper : snapshot) {
+            juce::MemoryBlock state;
+            wrapper->processor->getStateInformation(state);
+            stream.writeString(wrapper->processor->getName());
+            stream.writeInt((int)state.getSize());
+            stream.write(state.getData(), state.getSize());
+        }
+    }
+
+    // Applies per-processor state; the chain must have the same layout
+    void setStateInformation(const void* data, int sizeInBytes) override {
+        juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+        auto snapshot = getProcessors();
+        if (stream.readInt() != (int)snapshot.size()) return;
+        for (auto* wrapper : snapshot) {
+            if (stream.readString() != wrapper->processor->getName()) return;
+            juce::MemoryBlock state;
+            const int size = stream.readInt();
+            if (size < 0 || stream.readIntoMemoryBlock(state, size) != (size_t)size) return;
+            wrapper->processor->setStateInformation(state.getData(), (int)state.getSize());
+        }
+    }
+
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+private:
+    // Swaps in an edited list. Once this returns the audio thread no longer
+    // sees the old one, so a removed processor can be freed. chainLock held.
+    void publish(ProcessorList updated) {
+        auto contains = [](const ProcessorList& list, ProcessorWrapper* wrapper) {
+            return std::find(list.begin(), list.end(), wrapper) != list.end();
+        };
+        for (auto* wrapper : updated) {
+            if (!contains(*processors, wrapper)) wrapper->processor->addListener(this);
+        }
+        for (auto* wrapper : *processors) {
+            if (!contains(updated, wrapper)) wrapper->processor->removeListener(this);
+        }
+
+        auto replacement = std::make_unique<ProcessorList>(std::move(updated));
+        activeList.store(replacement.get());
+        audioThread.waitForAudioThread();
+        processors = std::move(replacement);
+        updateLatency();
+    }
+
+    // The chain reports its processors' total latency, so whatever runs it
+    // (a graph, a stream) sees a change inside it. Lock-free, since a
+    // processor may report a change from the audio thread.
+    void updateLatency() {
+        int total = 0;
+        {
+            const AudioThreadGuard::Scope scope(audioThread);
+            for (auto* wrapper : *activeList.load()) total += wrapper->processor->getLatencySamples();
+        }
+        setLatencySamples(total);
+    }
+
+    void audioProcessorChanged(juce::AudioProcessor*, const juce::AudioProcessorListener::ChangeDetails& details) override {
+        if (details.latencyChanged) updateLatency();
+    }
+
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override {}
+
+    // Replaced whole on every edit, so the list the audio thread is reading
+    // never changes under it. Not owned, unless also in ownedProcessors.
+    std::unique_ptr<ProcessorList> processors = std::make_unique<ProcessorList>();
+    std::atomic<ProcessorList*> activeList { processors.get() };
+    AudioThreadGuard audioThread;
+    std::vector<std::unique_ptr<ProcessorWrapper>> ownedProcessors;
+    mutable juce::CriticalSection chainLock; // Serialises edits; the audio thread never takes it
+    std::atomic<bool> autoBypass { false };
+    bool prepared = false;
+};
+
+static ChainProcessor* getChainProcessor(PedalboardChain chain) {
+    return static_cast<ChainProcessor*>(static_cast<ProcessorWrapper*>(chain)->processor.get());
+}
+
+// Creates an independent copy of a processor (or a whole chain) with the
+// same configuration. Returns nullptr if the processor can't be recreated.
+static std::unique_ptr<ProcessorWrapper> cloneWrapper(ProcessorWrapper* source) {
+    auto clone = std::make_unique<ProcessorWrapper>();
+    auto* sourceProcessor = source->processor.get();
+    const double sampleRate = sourceProcessor->getSampleRate() > 0 ? sourceProcessor->getSampleRate() : 44100.0;
+    const int blockSize = sourceProcessor->getBlockSize() > 0 ? sourceProcessor->getBlockSize() : 512;
+
+    if (auto* chain = dynamic_cast<ChainProcessor*>(sourceProcessor)) {
+        auto chainClone = std::make_unique<ChainProcessor>();
+        for (auto* child : chain->getProcessors()) {
+            auto childClone = cloneWrapper(child);
+            if (childClone == nullptr) return nullptr;
+            chainClone->appendOwned(std::move(childClone));
+        }
+        chainClone->setAutoBypass(chain->getAutoBypass());
+        clone->processor = std::move(chainClone);
+    } else if (source->kind == ProcessorWrapper::Kind::internal) {
+        auto internalClone = createInternalProcessor(sourceProcessor->getName());
+        if (internalClone == nullptr) return nullptr;
+
+        juce::MemoryBlock state;
+        sourceProcessor->getStateInformation(state);
+        internalClone->setStateInformation(state.getData(), (int)state.getSize());
+        clone->processor = std::move(internalClone);
+        clone->kind = ProcessorWrapper::Kind::internal;
+    } else if (source->kind == ProcessorWrapper::Kind::fused) {
+        auto fusedClone = createFusedChain(static_cast<FusedChainBase*>(sourceProcessor)->getStageNames());
+        if (fusedClone == nullptr) return nullptr;
+
+        juce::MemoryBlock state;
+        sourceProcessor->getStateInformation(state);
+        fusedClone->setStateInformation(state.getData(), (int)state.getSize());
+        clone->processor = std::move(fusedClone);
+        clone->kind = ProcessorWrapper::Kind::fused;
+    } else if (source->pluginDescription != nullptr) {
+        juce::String error;
+        auto plugin = g_internal->getPluginFormatManager().createPluginInstance(*source->pluginDescription, sampleRate, blockSize, error);
+        if (plugin == nullptr) return nullptr;
+
+        juce::MemoryBlock state;
+        sourceProcessor->getStateInformation(state);
+        plugin->setStateInformation(state.getData(), (int)state.getSize());
+
+        clone->processor = std::move(plugin);
+        clone->pluginDescription = std::make_unique<juce::PluginDescription>(*source->pluginDescription);
+    } else {
+        return nullptr;
+    }
+
+    // Hand back an instance prepared the same way as the source
+    if (sourceProcessor->getSampleRate() > 0) {
+        prepareProcessor(*clone->processor, sampleRate, blockSize, sourceProcessor->getTotalNumOutputChannels());
+    }
+
+    return clone;
+}
+
+PedalboardProcessor pedalboard_processor_clone(PedalboardProcessor processor) {
+    if (!processor) return nullptr;
+    return static_cast<PedalboardProcessor>(cloneWrapper(static_cast<ProcessorWrapper*>(processor)).release());
+}
+
+// --- Processor Pool ---
+// Pre-prepared clones of a prototype that concurrent jobs borrow and return.
+struct ProcessorPoolInternal {
+    std::unique_ptr<ProcessorWrapper> prototype;
+    juce::MemoryBlock prototypeState;
+    double sampleRate = 44100.0;
+    int maxBlockSize = 512;
+
+    std::vector<std::unique_ptr<ProcessorWrapper>> instances;
+    std::vector<ProcessorWrapper*> idle;
+    juce::CriticalSection lock;
+
+    ProcessorWrapper* createInstance() {
+        auto instance = cloneWrapper(prototype.get());
+        if (instance == nullptr) return nullptr;
+        prepareProcessor(*instance->processor, sampleRate, maxBlockSize);
+
+        const juce::ScopedLock sl(lock);
+        instances.push_back(std::move(instance));
+        return instances.back().get();
+    }
+};
+
+PedalboardProcessorPool pedalboard_processor_pool_create(PedalboardProcessor prototype, int initial_size, double sample_rate, int max_block_size) {
+    if (!prototype || sample_rate <= 0 || max_block_size <= 0) return nullptr;
+
+    auto pool = std::make_unique<ProcessorPoolInternal>();
+    pool->sampleRate = sample_rate;
+    pool->maxBlockSize = max_block_size;
+
+    // Snapshot the prototype so later edits to it don't leak into the pool
+    pool->prototype = cloneWrapper(static_cast<ProcessorWrapper*>(prototype));
+    if (pool->prototype == nullptr) return nullptr;
+    pool->prototype->processor->getStateInformation(pool->prototypeState);
+
+    for (int i = 0; i < initial_size; ++i) {
+        auto* instance = pool->createInstance();
+        if (instance == nullptr) return nullptr;
+        pool->idle.push_back(instance);
+    }
+    return static_cast<PedalboardProcessorPool>(pool.release());
+}
+
+PedalboardProcessor pedalboard_processor_pool_acquire(PedalboardProcessorPool pool) {
+    if (!pool) return nullptr;
+    auto* internal = static_cast<ProcessorPoolInternal*>(pool);
+    {
+        const juce::ScopedLock sl(internal->lock);
+        if (!internal->idle.empty()) {
+            auto* instance = internal->idle.back();
+            internal->idle.pop_back();
+            return static_cast<PedalboardProcessor>(instance);
+        }
+    }
+    // Pool exhausted: grow it rather than make the caller wait
+    return static_cast<PedalboardProcessor>(internal->createInstance());
+}
+
+void pedalboard_processor_pool_release(PedalboardProcessorPool pool, PedalboardProcessor processor) {
+    if (!pool || !processor) return;
+    auto* internal = static_cast<ProcessorPoolInternal*>(pool);
+    auto* instance = static_cast<ProcessorWrapper*>(processor);
+
+    // Restore the prototype configuration and clear any tails before reuse
+    instance->processor->setStateInformation(internal->prototypeState.getData(), (int)internal->prototypeState.getSize());
+    instance->processor->reset();
+
+    const juce::ScopedLock sl(internal->lock);
+    internal->idle.push_back(instance);
+}
+
+int pedalboard_processor_pool_get_num_available(PedalboardProcessorPool pool) {
+    if (!pool) return 0;
+    auto* internal = static_cast<ProcessorPoolInternal*>(pool);
+    const juce::ScopedLock sl(internal->lock);
+    return (int)internal->idle.size();
+}
+
+void pedalboard_processor_pool_free(PedalboardProcessorPool pool) {
+    if (pool) delete static_cast<ProcessorPoolInternal*>(pool);
+}
+
+PedalboardChain pedalboard_chain_create() {
+    auto wrapper = new ProcessorWrapper();
+    wrapper->processor = std::make_unique<ChainProcessor>();
+    return static_cast<PedalboardChain>(wrapper);
+}
+
+void pedalboard_chain_free(PedalboardChain chain) {
+    if (chain) delete static_cast<ProcessorWrapper*>(chain);
+}
+
+int pedalboard_chain_append(PedalboardChain chain, PedalboardProcessor processor) {
+    if (!chain) return 0;
+    return pedalboard_chain_insert(chain, pedalboard_chain_get_num_processors(chain), processor);
+}
+
+int pedalboard_chain_insert(PedalboardChain chain, int index, PedalboardProcessor processor) {
+    if (!chain || !processor || chain == processor) return 0;
+    return getChainProcessor(chain)->insert(index, static_cast<ProcessorWrapper*>(processor)) ? 1 : 0;
+}
+
+int pedalboard_chain_remove(PedalboardChain chain, int index) {
+    if (!chain) return 0;
+    return getChainProcessor(chain)->remove(index) ? 1 : 0;
+}
+
+int pedalboard_chain_get_num_processors(PedalboardChain chain) {
+    if (!chain) return 0;
+    return getChainProcessor(chain)->size();
+}
+
+void pedalboard_chain_set_auto_bypass(PedalboardChain chain, int enabled) {
+    if (chain) getChainProcessor(chain)->setAutoBypass(enabled != 0);
+}
+
+void pedalboard_chain_process(PedalboardChain chain, float** samples, int num_channels, int num_samples, double sample_rate) {
+    pedalboard_processor_process(static_cast<PedalboardProcessor>(chain), samples, num_channels, num_samples, sample_rate);
+}
+
+void pedalboard_chain_process_compact(PedalboardChain chain, PedalboardCompactAudioBuffer* buffer) {
+    pedalboard_processor_process_compact(static_cast<PedalboardProcessor>(chain), buffer);
+}
+
+PedalboardProcessor pedalboard_chain_as_processor(PedalboardChain chain) {
+    return static_cast<PedalboardProcessor>(chain);
+}
+
+// --- Processor Graph ---
+// Runs the nodes of one graph level on a fixed set of threads. The calling
+// thread takes part too, so a pool of N workers keeps N + 1 cores busy.
+// run() doesn't signal the workers, since waking a thread can take a lock
+// and a syscall. Instead, a worker that has had a job in the last
+// spinMilliseconds spins on the job counter, so while a graph is streaming
+// its workers pick up each level at once. An idle worker sleeps and checks
+// every millisecond, so the first blocks after a pause may run on the
+// calling thread alone.
+class GraphWorkerPool {
+public:
+    explicit GraphWorkerPool(int numWorkers) {
+        for (int i = 0; i < numWorkers; ++i) {
+            threads.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~GraphWorkerPool() {
+        stopping.store(true);
+        {
+            // A worker between checking and waiting holds the mutex, so this
+            // orders the flag before its wait
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        wake.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    // Calls task(context, i) for every i in [0, count) and returns once all
+    // are done. The caller drains tasks itself and then spins until the
+    // workers finish theirs; it never sleeps, takes a lock or wakes a
+    // thread, so it can be the audio thread. It can't take back a task a
+    // worker has started, though, so a slow branch on a worker delays the
+    // caller as long as it would running there.
+    void run(int count, void (*task)(void*, int), void* context) {
+        Job job { task, context, count };
+        job.remaining.store(count);
+        currentJob.store(&job);
+        generation.fetch_add(1);
+
+        drain(job);
+        while (job.remaining.load() != 0) std::this_thread::yield();
+
+        // Workers attach before loading currentJob, so once none is attached
+        // none can still reach this stack frame's job
+        currentJob.store(nullptr);
+        while (attachedWorkers.load() != 0) std::this_thread::yield();
+    }
+
+private:
+    struct Job {
+        void (*task)(void*, int);
+        void* context;
+        int count;
+        std::atomic<int> nextIndex { 0 };
+        std::atomic<int> remaining { 0 };
+    };
+
+    static void drain(Job& job) {
+        for (int i = job.nextIndex.fetch_add(1); i < job.count; i = job.nextIndex.fetch_add(1)) {
+            job.task(job.context, i);
+            job.remaining.fetch_sub(1);
+        }
+    }
+
+    static constexpr int spinMilliseconds = 50;
+
+    void workerLoop() {
+        using Clock = std::chrono::steady_clock;
+        uint64_t seen = 0;
+        auto lastJob = Clock::now() - std::chrono::milliseconds(spinMilliseconds);
+        while (!stopping.load()) {
+            const auto latest = generation.load();
+            if (latest != seen) {
+                seen = latest;
+                ++attachedWorkers;
+                if (auto* job = currentJob.load()) drain(*job);
+                --attachedWorkers;
+                lastJob = Clock::now();
+            } else if (Clock::now() - lastJob < std::chrono::milliseconds(spinMilliseconds)) {
+                std::this_thread::yield();
+            } else {
+                // Only the destructor notifies; run() is picked up by the timeout
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait_for(lock, std::chrono::milliseconds(1), [&] { return stopping.load() || generation.load() != seen; });
+            }
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex mutex; // Only idle workers wait on it
+    std::condition_variable wake;
+    std::atomic<bool> stopping { false };
+    std::atomic<uint64_t> generation { 0 };
+    std::atomic<Job*> currentJob { nullptr };
+    std::atomic<int> attachedWorkers { 0 };
+};
+
+// A graph of processor, mix and crossover nodes between a fixed input and
+// output node. Every node sums its incoming connections, so an output that
+// feeds several connections is a split. Nodes at the same depth run in
+// parallel, and shorter paths are delayed to match the longest one.
+//
+// Edits and latency changes build a new Topology on the calling thread and
+// publish it through an atomic pointer, so processBlock takes no locks and
+// never allocates. A latency change reported mid-block is rebuilt on the
+// shared graph thread instead.
+class GraphProcessor : public juce::AudioProcessor, private juce::AudioProcessorListener, private juce::TimeSliceClient {
+public:
+    GraphProcessor()
+        : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
+                                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)) {
+        nodes.push_back(std::make_unique<Node>(Node::Type::input));
+        nodes.push_back(std::make_unique<Node>(Node::Type::output));
+        g_internal->getGraphThread().addTimeSliceClient(this);
+    }
+
+    ~GraphProcessor() override {
+        g_internal->getGraphThread().removeTimeSliceClient(this);
+        for (auto& node : nodes) {
+            if (node->type == Node::Type::processor) node->wrapper->processor->removeListener(this);
+        }
+        workers.reset(); // Join workers before nodes go away
+    }
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        const juce::ScopedLock sl(graphLock);
+        numChannels = getTotalNumOutputChannels();
+        blockSize = samplesPerBlock;
+
+        for (auto& node : nodes) {
+            if (node->type == Node::Type::processor) {
+                prepareProcessor(*node->wrapper->processor, sampleRate, samplesPerBlock, numChannels);
+            } else if (node->type == Node::Type::crossover) {
+                prepareCrossover(*node, sampleRate);
+            }
+            for (auto& port : node->ports) port.setSize(numChannels, samplesPerBlock);
+        }
+        prepared = true;
+        updateLatencies();
+        rebuild();
+    }
+
+    void releaseResources() override {
+        const juce::ScopedLock sl(graphLock);
+        prepared = false;
+        publish(nullptr);
+        for (auto& node : nodes) {
+            if (node->type == Node::Type::processor) node->wrapper->processor->releaseResources();
+        }
+    }
+
+    void reset() override {
+        const juce::ScopedLock sl(graphLock);
+        for (auto& node : nodes) {
+            if (node->type == Node::Type::processor) node->wrapper->processor->reset();
+            if (node->type == Node::Type::crossover) node->crossover.reset();
+        }
+        for (auto& edge : edges) {
+            if (edge.delay != nullptr) edge.delay->clear();
+        }
+    }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+        const AudioThreadGuard::Scope scope(audioThread);
+        const auto* topology = activeTopology.load();
+        if (topology == nullptr) return; // Not prepared
+        auto* pool = activeWorkers.load();
+
+        const int channels = juce::jmin(buffer.getNumChannels(), topology->numChannels);
+        for (int start = 0; start < buffer.getNumSamples(); start += topology->blockSize) {
+            const int numSamples = juce::jmin(topology->blockSize, buffer.getNumSamples() - start);
+
+            auto& input = topology->nodes[inputNode]->ports[0];
+            input.clear(0, numSamples);
+            for (int ch = 0; ch < channels; ++ch) input.copyFrom(ch, 0, buffer, ch, start, numSamples);
+
+            for (const auto& level : topology->levels) {
+                if (pool != nullptr && level.size() > 1) {
+                    LevelTask task { topology, &level, numSamples };
+                    pool->run((int)level.size(), runLevelNode, &task);
+                } else {
+                    for (int id : level) runNode(*topology, id, numSamples);
+                }
+            }
+
+            auto& output = topology->nodes[outputNode]->ports[0];
+            for (int ch = 0; ch < channels; ++ch) buffer.copyFrom(ch, start, output, ch, 0, numSamples);
+        }
+    }
+
+    int addProcessor(ProcessorWrapper* wrapper) {
+        if (wrapper == nullptr || wrapper->processor.get() == this) return -1;
+
+        // Prepare outside the lock so edits and rebuilds aren't held up
+        if (prepared) prepareProcessor(*wrapper->processor, getSampleRate(), getBlockSize(), getTotalNumOutputChannels());
+
+        const juce::ScopedLock sl(graphLock);
+        for (auto& node : nodes) {
+            if (node->wrapper == wrapper) return -1; // Each processor keeps a single state
+        }
+        auto node = std::make_unique<Node>(Node::Type::processor);
+        node->wrapper = wrapper;
+        wrapper->processor->addListener(this);
+        return addNode(std::move(node));
+    }
+
+    int addMix(float gain) {
+        const juce::ScopedLock sl(graphLock);
+        auto node = std::make_unique<Node>(Node::Type::mix);
+        node->gain.store(gain);
+        node->lastGain = gain;
+        return addNode(std::move(node));
+    }
+
+    int addCrossover(float frequency) {
+        if (frequency <= 0.0f) return -1;
+        const juce::ScopedLock sl(graphLock);
+        auto node = std::make_unique<Node>(Node::Type::crossover);
+        node->frequency = frequency;
+        if (prepared) prepareCrossover(*node, getSampleRate());
+        return addNode(std::move(node));
+    }
+
+    // Ramps to the new gain over the next block.
+    bool setMixGain(int id, float gain) {
+        const juce::ScopedLock sl(graphLock);
+        if (id < 0 || id >= (int)nodes.size() || nodes[(size_t)id]->type != Node::Type::mix) return false;
+        nodes[(size_t)id]->gain.store(gain);
+        return true;
+    }
+
+    bool connect(int source, int sourcePort, int dest) {
+        const juce::ScopedLock sl(graphLock);
+        if (!isValidPort(source, sourcePort) || dest < 0 || dest >= (int)nodes.size() || dest == inputNode || source == outputNode) return false;
+        for (auto& edge : edges) {
+            if (edge.source == source && edge.sourcePort == sourcePort && edge.dest == dest) return false;
+        }
+
+        edges.push_back({ source, sourcePort, dest });
+        if (!rebuild()) {
+            edges.pop_back(); // Would create a cycle; the published topology is unchanged
+            return false;
+        }
+        return true;
+    }
+
+    bool disconnect(int source, int sourcePort, int dest) {
+        const juce::ScopedLock sl(graphLock);
+        for (auto it = edges.begin(); it != edges.end(); ++it) {
+            if (it->source == source && it->sourcePort == sourcePort && it->dest == dest) {
+                edges.erase(it);
+                rebuild();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // numThreads of 1 runs everything on the calling thread; 0 uses one per CPU.
+    void setNumThreads(int numThreads) {
+        const int total = numThreads > 0 ? numThreads : juce::SystemStats::getNumCpus();
+        std::unique_ptr<GraphWorkerPool> pool;
+        if (total > 1) pool = std::make_unique<GraphWorkerPool>(total - 1);
+
+        const juce::ScopedLock sl(graphLock);
+        activeWorkers.store(pool.get());
+        audioThread.waitForAudioThread();
+        std::swap(workers, pool); // The old pool is joined here, no longer in use
+    }
+
+    static constexpr int inputNode = PEDALBOARD_GRAPH_INPUT_NODE;
+    static constexpr int outputNode = PEDALBOARD_GRAPH_OUTPUT_NODE;
+
+    const juce::String getName() const override { return "Graph"; }
+
+    // Branches run in parallel, so the longest one sets the tail. Latency,
+    // compensation included, is reported separately. Lock-free, since
+    // auto-bypass asks for it from the audio thread.
+    double getTailLengthSeconds() const override {
+        const AudioThreadGuard::Scope scope(audioThread);
+        const auto* topology = activeTopology.load();
+        if (topology == nullptr) return 0.0;
+
+        double tail = 0.0, filterTail = 0.0;
+        for (const auto* node : topology->nodes) {
+            if (node->type == Node::Type::processor) {
+                tail = juce::jmax(tail, node->wrapper->processor->getTailLengthSeconds());
+            } else if (node->type == Node::Type::crossover && node->frequency > 0.0f) {
+                // Butterworth sections ring with time constant 1 / (sqrt(2) * pi * f)
+                const double timeConstant = 1.0 / (juce::MathConstants<double>::sqrt2 * juce::MathConstants<double>::pi * node->frequency);
+                filterTail = juce::jmax(filterTail, timeConstant * -std::log((double)silenceThreshold));
+            }
+        }
+        return tail + filterTail;
+    }
+
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+private:
+    // Per-node processing state. Nodes are never removed, and only the
+    // thread running a block touches their buffers and filters.
+    struct Node {
+        enum class Type { input, output, processor, mix, crossover };
+        explicit Node(Type t) : type(t) {}
+
+        Type type;
+        ProcessorWrapper* wrapper = nullptr; // Processor nodes, not owned
+        std::atomic<float> gain { 1.0f };    // Mix nodes
+        float lastGain = 1.0f;
+        float frequency = 0.0f;              // Crossover nodes
+        juce::dsp::LinkwitzRileyFilter<float> crossover;
+
+        // Port 0 is the summed input, processed in place; crossovers write
+        // their low band to port 0 and their high band to port 1.
+        juce::AudioBuffer<float> ports[2];
+        juce::AudioBuffer<float> view;
+
+        // Only read and written under graphLock
+        int ownLatency = 0;
+        int latency = 0; // Latency of this node's output relative to the graph input
+    };
+
+    // Ring of `compensation` samples per channel. Shared by successive
+    // topologies while an edge's compensation is unchanged, so rebuilding
+    // for an unrelated edit keeps the audio in flight.
+    struct DelayRing {
+        DelayRing(int channels, int length) : buffer(channels, length) { buffer.clear(); }
+        void clear() { buffer.clear(); position = 0; }
+
+        juce::AudioBuffer<float> buffer;
+        int position = 0;
+    };
+
+    struct Edge {
+        int source;
+        int sourcePort;
+        int dest;
+        std::shared_ptr<DelayRing> delay; // Null without compensation
+    };
+
+    // What processBlock reads about the graph's shape. Immutable once published.
+    struct Topology {
+        struct Route {
+            const Node* source;
+            int sourcePort;
+            int compensation; // Delay added to line the source up with the dest's other inputs
+            std::shared_ptr<DelayRing> delay;
+        };
+
+        std::vector<Node*> nodes;
+        std::vector<std::vector<Route>> incoming; // Per node
+        std::vector<std::vector<int>> levels;
+        int numChannels = 0;
+        int blockSize = 0;
+    };
+
+    struct LevelTask {
+        const Topology* topology;
+        const std::vector<int>* level;
+        int numSamples;
+    };
+
+    int addNode(std::unique_ptr<Node> node) {
+        for (auto& port : node->ports) port.setSize(numChannels, blockSize);
+        nodes.push_back(std::move(node));
+        updateLatencies();
+        rebuild();
+        return (int)nodes.size() - 1;
+    }
+
+    bool isValidPort(int id, int port) const {
+        if (id < 0 || id >= (int)nodes.size()) return false;
+        return port == 0 || (port == 1 && nodes[(size_t)id]->type == Node::Type::crossover);
+    }
+
+    void prepareCrossover(Node& node, double sampleRate) {
+        juce::dsp::ProcessSpec spec { sampleRate, (uint32_t)juce::jmax(1, blockSize), (uint32_t)juce::jmax(1, numChannels) };
+        node.crossover.prepare(spec);
+        node.crossover.setCutoffFrequency(juce::jmin(node.frequency, (float)(sampleRate * 0.49)));
+    }
+
+    // Orders nodes into levels, sizes the latency compensation delays and
+    // publishes the result if prepared. Returns false, leaving the current
+    // topology in place, if the edges contain a cycle. graphLock held.
+    bool rebuild() {
+        const int count = (int)nodes.size();
+        std::vector<int> depth((size_t)count, 0), pendingInputs((size_t)count, 0);
+        std::vector<std::vector<int>> incomingEdges((size_t)count);
+        for (int e = 0; e < (int)edges.size(); ++e) {
+            incomingEdges[(size_t)edges[(size_t)e].dest].push_back(e);
+            ++pendingInputs[(size_t)edges[(size_t)e].dest];
+        }
+
+        // Kahn's algorithm; latency is settled as each node's inputs complete
+        std::vector<int> order, ready;
+        std::vector<int> latency((size_t)count, 0);
+        for (int i = 0; i < count; ++i) {
+            if (pendingInputs[(size_t)i] == 0) ready.push_back(i);
+        }
+        while (!ready.empty()) {
+            const int id = ready.back();
+            ready.pop_back();
+            order.push_back(id);
+
+            int arrival = 0;
+            for (int e : incomingEdges[(size_t)id]) arrival = juce::jmax(arrival, latency[(size_t)edges[(size_t)e].source]);
+            latency[(size_t)id] = arrival + nodes[(size_t)id]->ownLatency;
+
+            for (int e = 0; e < (int)edges.size(); ++e) {
+                const auto& edge = edges[(size_t)e];
+                if (edge.source != id) continue;
+                depth[(size_t)edge.dest] = juce::jmax(depth[(size_t)edge.dest], depth[(size_t)id] + 1);
+                if (--pendingInputs[(size_t)edge.dest] == 0) ready.push_back(edge.dest);
+            }
+        }
+        if ((int)order.size() != count) return false;
+
+        auto topology = std::make_unique<Topology>();
+        topology->numChannels = numChannels;
+        topology->blockSize = blockSize;
+        for (auto& node : nodes) topology->nodes.push_back(node.get());
+        for (int id : order) {
+            const auto d = (size_t)depth[(size_t)id];
+            if (topology->levels.size() <= d) topology->levels.resize(d + 1);
+            topology->levels[d].push_back(id);
+        }
+
+        // Edges keep their ring while its length and channel count still fit
+        topology->incoming.resize((size_t)count);
+        for (int id = 0; id < count; ++id) {
+            nodes[(size_t)id]->latency = latency[(size_t)id];
+            int arrival = 0;
+            for (int e : incomingEdges[(size_t)id]) arrival = juce::jmax(arrival, latency[(size_t)edges[(size_t)e].source]);
+
+            for (int e : incomingEdges[(size_t)id]) {
+                auto& edge = edges[(size_t)e];
+                const int compensation = arrival - latency[(size_t)edge.source];
+                if (compensation == 0) {
+                    edge.delay.reset();
+                } else if (edge.delay == nullptr || edge.delay->buffer.getNumSamples() != compensation
+                           || edge.delay->buffer.getNumChannels() != numChannels) {
+                    edge.delay = std::make_shared<DelayRing>(numChannels, compensation);
+                }
+                topology->incoming[(size_t)id].push_back({ nodes[(size_t)edge.source].get(), edge.sourcePort, compensation, edge.delay });
+            }
+        }
+
+        setLatencySamples(nodes[outputNode]->latency);
+        if (prepared) publish(std::move(topology));
+        return true;
+    }
+
+    // Swaps in a new topology (or none). Once this returns the audio thread
+    // no longer reads the old one, so it and any ring only it used are freed.
+    void publish(std::unique_ptr<Topology> replacement) {
+        activeTopology.store(replacement.get());
+        audioThread.waitForAudioThread();
+        currentTopology = std::move(replacement);
+    }
+
+    // Picks up processor latency changes, e.g. a Distortion mode switch.
+    // Returns true if the compensation delays need rebuilding.
+    bool updateLatencies() {
+        bool changed = false;
+        for (auto& node : nodes) {
+            if (node->type != Node::Type::processor) continue;
+            const int latency = node->wrapper->processor->getLatencySamples();
+            if (latency != node->ownLatency) {
+                node->ownLatency = latency;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    // A processor's latency changed. Reported from a control thread, the
+    // compensation is rebuilt right away, so the next block already uses it.
+    // Reported mid-block, or while another thread is editing the graph
+    // (which may hold a lock this change was reported under), it is left
+    // for the graph thread.
+    void audioProcessorChanged(juce::AudioProcessor*, const juce::AudioProcessorListener::ChangeDetails& details) override {
+        if (!details.latencyChanged) return;
+        if (processingDepth == 0) {
+            const juce::ScopedTryLock sl(graphLock);
+            if (sl.isLocked()) {
+                if (updateLatencies()) rebuild();
+                return;
+            }
+        }
+        latencyChanged.store(true);
+    }
+
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override {}
+
+    int useTimeSlice() override {
+        if (latencyChanged.exchange(false)) {
+            const juce::ScopedLock sl(graphLock);
+            if (updateLatencies()) rebuild();
+        }
+        return 10;
+    }
+
+    static void runLevelNode(void* context, int index) {
+        auto* task = static_cast<LevelTask*>(context);
+        runNode(*task->topology, (*task->level)[(size_t)index], task->numSamples);
+    }
+
+    static void runNode(const Topology& topology, int id, int n) {
+        auto& node = *topology.nodes[(size_t)id];
+        if (node.type == Node::Type::input) return;
+
+        auto& dest = node.ports[0];
+        dest.clear(0, n);
+        for (const auto& route : topology.incoming[(size_t)id]) accumulate(route, dest, topology.numChannels, n);
+
+        switch (node.type) {
+            case Node::Type::processor:
+                node.view.setDataToReferTo(dest.getArrayOfWritePointers(), topology.numChannels, n);
+                node.wrapper->midiBuffer.clear();
+                node.wrapper->processBlock(node.view);
+                break;
+            case Node::Type::mix: {
+                const float gain = node.gain.load();
+                dest.applyGainRamp(0, n, node.lastGain, gain);
+                node.lastGain = gain;
+                break;
+            }
+            case Node::Type::crossover:
+                for (int ch = 0; ch < topology.numChannels; ++ch) {
+                    float* low = dest.getWritePointer(ch);
+                    float* high = node.ports[1].getWritePointer(ch);
+                    for (int i = 0; i < n; ++i) node.crossover.processSample(ch, low[i], low[i], high[i]);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Adds the route's source into dest, through its compensation delay if it has one.
+    static void accumulate(const Topology::Route& route, juce::AudioBuffer<float>& dest, int numChannels, int n) {
+        const auto& source = route.source->ports[route.sourcePort];
+        if (route.compensation == 0) {
+            for (int ch = 0; ch < numChannels; ++ch) dest.addFrom(ch, 0, source, ch, 0, n);
+            return;
+        }
+
+        // Each ring slot hands out the sample written `compensation` samples ago
+        auto& ring = *route.delay;
+        int position = ring.position;
+        for (int done = 0; done < n;) {
+            const int span = juce::jmin(n - done, route.compensation - position);
+            for (int ch = 0; ch < numChannels; ++ch) {
+                float* slot = ring.buffer.getWritePointer(ch) + position;
+                juce::FloatVectorOperations::add(dest.getWritePointer(ch) + done, slot, span);
+                juce::FloatVectorOperations::copy(slot, source.getReadPointer(ch) + done, span);
+            }
+            position = (position + span) % route.compensation;
+            done += span;
+        }
+        ring.position = position;
     }
-    
-    wrapper->processor->processBlock(buffer, wrapper->midiBuffer);
+
+    // Edited under graphLock, never read by processBlock
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<Edge> edges;
+    std::unique_ptr<GraphWorkerPool> workers;
+    bool prepared = false;
+    int numChannels = 0;
+    int blockSize = 0;
+    mutable juce::CriticalSection graphLock; // Serialises edits; the audio thread never takes it
+
+    // Published to processBlock
+    std::unique_ptr<Topology> currentTopology;
+    std::atomic<Topology*> activeTopology { nullptr };
+    std::atomic<GraphWorkerPool*> activeWorkers { nullptr };
+    AudioThreadGuard audioThread;
+    std::atomic<bool> latencyChanged { false };
+};
+
+static GraphProcessor* getGraphProcessor(PedalboardGraph graph) {
+    return static_cast<GraphProcessor*>(static_cast<ProcessorWrapper*>(graph)->processor.get());
+}
+
+PedalboardGraph pedalboard_graph_create() {
+    pedalboard_init();
+    auto wrapper = new ProcessorWrapper();
+    wrapper->processor = std::make_unique<GraphProcessor>();
+    return static_cast<PedalboardGraph>(wrapper);
+}
+
+void pedalboard_graph_free(PedalboardGraph graph) {
+    if (graph) delete static_cast<ProcessorWrapper*>(graph);
+}
+
+int pedalboard_graph_add_processor(PedalboardGraph graph, PedalboardProcessor processor) {
+    if (!graph || !processor || graph == processor) return -1;
+    return getGraphProcessor(graph)->addProcessor(static_cast<ProcessorWrapper*>(processor));
+}
+
+int pedalboard_graph_add_mix(PedalboardGraph graph, float gain) {
+    if (!graph) return -1;
+    return getGraphProcessor(graph)->addMix(gain);
+}
+
+int pedalboard_graph_add_crossover(PedalboardGraph graph, float frequency) {
+    if (!graph) return -1;
+    return getGraphProcessor(graph)->addCrossover(frequency);
+}
+
+int pedalboard_graph_set_mix_gain(PedalboardGraph graph, int node, float gain) {
+    if (!graph) return 0;
+    return getGraphProcessor(graph)->setMixGain(node, gain) ? 1 : 0;
+}
+
+int pedalboard_graph_connect(PedalboardGraph graph, int source, int source_port, int dest) {
+    if (!graph) return 0;
+    return getGraphProcessor(graph)->connect(source, source_port, dest) ? 1 : 0;
+}
+
+int pedalboard_graph_disconnect(PedalboardGraph graph, int source, int source_port, int dest) {
+    if (!graph) return 0;
+    return getGraphProcessor(graph)->disconnect(source, source_port, dest) ? 1 : 0;
+}
+
+void pedalboard_graph_set_num_threads(PedalboardGraph graph, int num_threads) {
+    if (graph) getGraphProcessor(graph)->setNumThreads(num_threads);
+}
+
+int pedalboard_graph_get_latency_samples(PedalboardGraph graph) {
+    if (!graph) return 0;
+    return getGraphProcessor(graph)->getLatencySamples();
+}
+
+void pedalboard_graph_process(PedalboardGraph graph, float** samples, int num_channels, int num_samples, double sample_rate) {
+    pedalboard_processor_process(static_cast<PedalboardProcessor>(graph), samples, num_channels, num_samples, sample_rate);
+}
+
+PedalboardProcessor pedalboard_graph_as_processor(PedalboardGraph graph) {
+    return static_cast<PedalboardProcessor>(graph);
+}
+
+// --- Resampled Processor ---
+// Runs a processor at a fixed internal rate whatever rate it is called at.
+// The inner processor is only ever prepared at that rate, so calls at
+// different rates neither reset its state nor repeat its prepareToPlay.
+class ResamplingProcessor : public juce::AudioProcessor {
+public:
+    ResamplingProcessor(ProcessorWrapper* innerWrapper, double rate)
+        : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
+                                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+          inner(innerWrapper), internalRate(rate) {}
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        numChannels = getTotalNumOutputChannels();
+        blockSize = samplesPerBlock;
+        resampling = sampleRate != internalRate;
+        offsetChannels.assign((size_t)numChannels, nullptr);
+
+        const double toInternalRatio = internalRate / sampleRate;
+        const int internalBlock = (int)std::ceil(samplesPerBlock * toInternalRatio) + 16;
+        auto& processor = *inner->processor;
+        if (processor.getSampleRate() != internalRate
+            || processor.getBlockSize() < internalBlock
+            || processor.getTotalNumOutputChannels() != numChannels) {
+            prepareProcessor(processor, internalRate, internalBlock, numChannels);
+        }
+
+        if (resampling) {
+            toInternal.prepare(sampleRate, internalRate, numChannels, samplesPerBlock);
+            internalBuffer.setSize(numChannels, toInternal.maxOutputFor(samplesPerBlock));
+
+            // Each block yields a couple of internal samples more or fewer than
+            // the way back needs; priming with silence absorbs the difference
+            primeSamples = (int)std::ceil(2.0 * toInternalRatio) + 4;
+            fromInternal.prepare(internalRate, sampleRate, numChannels, internalBuffer.getNumSamples() + primeSamples);
+            fromInternal.pushSilence(primeSamples);
+        }
+        updateLatency(sampleRate);
+    }
+
+    void releaseResources() override {}
+
+    void reset() override {
+        inner->processor->reset();
+        if (resampling) {
+            toInternal.reset();
+            fromInternal.reset();
+            fromInternal.pushSilence(primeSamples);
+        }
+    }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+        const int channels = juce::jmin(buffer.getNumChannels(), numChannels);
+        if (!resampling) {
+            processWrapper(inner, buffer.getArrayOfWritePointers(), channels, buffer.getNumSamples(), internalRate);
+            return;
+        }
+
+        for (int start = 0; start < buffer.getNumSamples(); start += blockSize) {
+            const int numSamples = juce::jmin(blockSize, buffer.getNumSamples() - start);
+            float* const* channelData = buffer.getArrayOfWritePointers();
+            for (int ch = 0; ch < channels; ++ch) offsetChannels[(size_t)ch] = channelData[ch] + start;
+
+            // Both resamplers are sized for one outer block of this size, so
+            // neither push can come up short
+            toInternal.push(offsetChannels.data(), channels, numSamples);
+            const int internalSamples = toInternal.pull(internalBuffer.getArrayOfWritePointers(), numChannels, internalBuffer.getNumSamples());
+            if (internalSamples > 0) {
+                processWrapper(inner, internalBuffer.getArrayOfWritePointers(), numChannels, internalSamples, internalRate);
+                fromInternal.push(internalBuffer.getArrayOfReadPointers(), numChannels, internalSamples);
+            }
+
+            const int produced = fromInternal.pull(offsetChannels.data(), channels, numSamples);
+            for (int ch = 0; ch < channels; ++ch) {
+                juce::FloatVectorOperations::clear(offsetChannels[(size_t)ch] + produced, numSamples - produced);
+            }
+        }
+    }
+
+    const juce::String getName() const override { return "Resampled"; }
+    double getTailLengthSeconds() const override { return inner->processor->getTailLengthSeconds(); }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock& destData) override { inner->processor->getStateInformation(destData); }
+    void setStateInformation(const void* data, int sizeInBytes) override { inner->processor->setStateInformation(data, sizeInBytes); }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+private:
+    // Both conversions plus the priming, expressed at the outer rate
+    void updateLatency(double sampleRate) {
+        const double innerLatency = inner->processor->getLatencySamples();
+        double latency = innerLatency * sampleRate / internalRate;
+        if (resampling) {
+            latency += StreamingResampler::getLatency()
+                     + (StreamingResampler::getLatency() + primeSamples) * sampleRate / internalRate;
+        }
+        setLatencySamples(juce::roundToInt(latency));
+    }
+
+    ProcessorWrapper* inner; // Not owned
+    const double internalRate;
+    bool resampling = false;
+    int numChannels = 0;
+    int blockSize = 0;
+    int primeSamples = 0;
+    StreamingResampler toInternal, fromInternal;
+    juce::AudioBuffer<float> internalBuffer;
+    std::vector<float*> offsetChannels; // One per prepared channel
+};
+
+PedalboardProcessor pedalboard_create_resampled_processor(PedalboardProcessor processor, double internal_rate) {
+    if (!processor || internal_rate <= 0) return nullptr;
+    auto wrapper = new ProcessorWrapper();
+    wrapper->processor = std::make_unique<ResamplingProcessor>(static_cast<ProcessorWrapper*>(processor), internal_rate);
+    return static_cast<PedalboardProcessor>(wrapper);
+}
+
+// --- Process Context ---
+struct ProcessContextInternal {
+    ProcessorWrapper* wrapper = nullptr; // Not owned
+    int numChannels = 0;
+    int maxSamples = 0;
+    juce::HeapBlock<float*> channels;       // Caller-filled pointer table
+    juce::HeapBlock<float*> planarChannels; // Points into planar
+    juce::HeapBlock<float> planar;
+};
+
+PedalboardProcessContext pedalboard_process_context_create(PedalboardProcessor processor, int num_channels, int max_samples) {
+    if (!processor || num_channels <= 0 || max_samples <= 0) return nullptr;
+
+    auto* ctx = new ProcessContextInternal();
+    ctx->wrapper = static_cast<ProcessorWrapper*>(processor);
+    ctx->numChannels = num_channels;
+    ctx->maxSamples = max_samples;
+    ctx->channels.calloc((size_t)num_channels);
+    ctx->planarChannels.malloc((size_t)num_channels);
+    ctx->planar.calloc((size_t)num_channels * (size_t)max_samples);
+    for (int i = 0; i < num_channels; ++i) {
+        ctx->planarChannels[i] = ctx->planar.get() + (size_t)i * (size_t)max_samples;
+        ctx->channels[i] = ctx->planarChannels[i];
+    }
+    return static_cast<PedalboardProcessContext>(ctx);
+}
+
+void pedalboard_process_context_free(PedalboardProcessContext context) {
+    if (context) delete static_cast<ProcessContextInternal*>(context);
+}
+
+float** pedalboard_process_context_get_channels(PedalboardProcessContext context) {
+    if (!context) return nullptr;
+    return static_cast<ProcessContextInternal*>(context)->channels.get();
+}
+
+float* pedalboard_process_context_get_buffer(PedalboardProcessContext context) {
+    if (!context) return nullptr;
+    return static_cast<ProcessContextInternal*>(context)->planar.get();
+}
+
+void pedalboard_process_context_process(PedalboardProcessContext context, int num_samples, double sample_rate) {
+    if (!context || num_samples <= 0) return;
+    auto* ctx = static_cast<ProcessContextInternal*>(context);
+    processWrapper(ctx->wrapper, ctx->channels.get(), ctx->numChannels, num_samples, sample_rate);
+}
+
+void pedalboard_process_context_process_automated(PedalboardProcessContext context, int num_samples, double sample_rate,
+                                                  const PedalboardParameterEvent* events, int num_events) {
+    if (!context || num_samples <= 0) return;
+    auto* ctx = static_cast<ProcessContextInternal*>(context);
+    processAutomated(ctx->wrapper, ctx->channels.get(), ctx->numChannels, num_samples, sample_rate,
+                     events, events != nullptr ? num_events : 0);
+}
+
+void pedalboard_process_context_process_buffer(PedalboardProcessContext context, int num_samples, double sample_rate) {
+    if (!context || num_samples <= 0) return;
+    auto* ctx = static_cast<ProcessContextInternal*>(context);
+    processWrapper(ctx->wrapper, ctx->planarChannels.get(), ctx->numChannels, juce::jmin(num_samples, ctx->maxSamples), sample_rate);
+}
+
+void pedalboard_process_context_process_interleaved(PedalboardProcessContext context, float* samples, int num_frames, double sample_rate) {
+    if (!context || !samples || num_frames <= 0) return;
+    auto* ctx = static_cast<ProcessContextInternal*>(context);
+    const int numChannels = ctx->numChannels;
+
+    for (int start = 0; start < num_frames; start += ctx->maxSamples) {
+        const int numSamples = juce::jmin(ctx->maxSamples, num_frames - start);
+        float* frames = samples + (size_t)start * (size_t)numChannels;
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* dest = ctx->planarChannels[ch];
+            for (int i = 0; i < numSamples; ++i) dest[i] = frames[i * numChannels + ch];
+        }
+
+        processWrapper(ctx->wrapper, ctx->planarChannels.get(), numChannels, numSamples, sample_rate);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* src = ctx->planarChannels[ch];
+            for (int i = 0; i < numSamples; ++i) frames[i * numChannels + ch] = src[i];
+        }
+    }
+}
+
+// --- Render Cache ---
+// Rendered output files keyed by everything that determines them: the input
+// file's bytes, the chain's structure and every processor's state, the
+// sample rate and the output format. An identical render copies the stored
+// file instead of processing. Files are kept in memory up to a byte budget,
+// evicting the least recently used, and optionally in a directory that
+// persists between runs.
+class RenderCache {
+public:
+    RenderCache(size_t maxBytes, const juce::File& cacheDirectory)
+        : maxMemoryBytes(maxBytes), directory(cacheDirectory) {
+        if (directory != juce::File()) directory.createDirectory();
+    }
+
+    // Writes the render stored under key to output. Returns false on a miss.
+    bool fetch(const juce::String& key, const juce::File& output) {
+        if (auto data = findInMemory(key)) {
+            if (output.replaceWithData(data->getData(), data->getSize())) {
+                ++hits;
+                return true;
+            }
+        } else if (directory != juce::File()) {
+            const auto file = getCacheFile(key, output);
+            if (file.existsAsFile() && file.copyFileTo(output)) {
+                insertFile(key, file);
+                ++hits;
+                return true;
+            }
+        }
+        ++misses;
+        return false;
+    }
+
+    // Stores a finished render of key, read back from output.
+    void store(const juce::String& key, const juce::File& output) {
+        if (directory != juce::File()) {
+            // Written aside and moved into place, so concurrent readers never see a partial file
+            const auto file = getCacheFile(key, output);
+            juce::TemporaryFile temp(file);
+            if (output.copyFileTo(temp.getFile())) temp.overwriteTargetFileWithTemporary();
+        }
+        insertFile(key, output);
+    }
+
+    // Empties the memory cache; files in the directory are kept.
+    void clear() {
+        const juce::ScopedLock sl(lock);
+        entries.clear();
+        index.clear();
+        memoryBytes = 0;
+    }
+
+    void getStats(PedalboardRenderCacheStats& stats) const {
+        const juce::ScopedLock sl(lock);
+        stats.hits = hits.load();
+        stats.misses = misses.load();
+        stats.memory_bytes = (int64_t)memoryBytes;
+        stats.num_entries = (int)entries.size();
+    }
+
+private:
+    using Data = std::shared_ptr<const juce::MemoryBlock>;
+
+    juce::File getCacheFile(const juce::String& key, const juce::File& output) const {
+        return directory.getChildFile(key + output.getFileExtension().toLowerCase());
+    }
+
+    Data findInMemory(const juce::String& key) {
+        const juce::ScopedLock sl(lock);
+        auto found = index.find(key);
+        if (found == index.end()) return nullptr;
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->second;
+    }
+
+    void insertFile(const juce::String& key, const juce::File& file) {
+        if ((juce::uint64)file.getSize() > maxMemoryBytes) return;
+        auto data = std::make_shared<juce::MemoryBlock>();
+        if (!file.loadFileAsData(*data)) return;
+
+        const juce::ScopedLock sl(lock);
+        if (index.count(key) != 0) return;
+        memoryBytes += data->getSize();
+        entries.emplace_front(key, std::move(data));
+        index[key] = entries.begin();
+
+        while (memoryBytes > maxMemoryBytes) {
+            memoryBytes -= entries.back().second->getSize();
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+    const size_t maxMemoryBytes;
+    const juce::File directory;
+
+    juce::CriticalSection lock;
+    std::list<std::pair<juce::String, Data>> entries; // Most recently used first
+    std::map<juce::String, std::list<std::pair<juce::String, Data>>::iterator> index;
+    size_t memoryBytes = 0;
+    std::atomic<int64_t> hits { 0 }, misses { 0 };
+};
+
+// Hashes what a processor renders: a chain's structure, and each leaf's
+// type and full state. Returns false for processors the batch renderer
+// can't copy, which are never cached.
+static bool hashProcessor(ContentHash& hash, ProcessorWrapper* wrapper) {
+    auto* processor = wrapper->processor.get();
+    if (auto* chain = dynamic_cast<ChainProcessor*>(processor)) {
+        const auto children = chain->getProcessors();
+        hash.addString("chain");
+        hash.addInt((juce::int64)children.size());
+        hash.addInt(chain->getAutoBypass() ? 1 : 0);
+        for (auto* child : children) {
+            if (!hashProcessor(hash, child)) return false;
+        }
+        return true;
+    }
+
+    if (wrapper->pluginDescription != nullptr) {
+        hash.addString(wrapper->pluginDescription->createIdentifierString());
+    } else if (wrapper->kind != ProcessorWrapper::Kind::other) {
+        hash.addString(processor->getName());
+    } else {
+        return false;
+    }
+
+    juce::MemoryBlock state;
+    processor->getStateInformation(state);
+    hash.addBlock(state);
+    return true;
+}
+
+// The cache key for rendering input with a chain hashed to chainKey. Returns
+// an empty string if the input can't be read.
+static juce::String getRenderKey(const juce::String& chainKey, const juce::File& input, double sampleRate, const juce::File& output) {
+    juce::FileInputStream stream(input);
+    if (!stream.openedOk()) return {};
+
+    ContentHash hash;
+    hash.addString(chainKey);
+    hash.addDouble(sampleRate);
+    hash.addString(output.getFileExtension().toLowerCase());
+
+    juce::HeapBlock<char> chunk(65536);
+    for (int numRead; (numRead = stream.read(chunk.get(), 65536)) > 0;) {
+        hash.add(chunk.get(), (size_t)numRead);
+    }
+    return hash.toString();
+}
+
+// --- Batch Rendering ---
+static constexpr int batchBlockSize = 4096;
+static constexpr int batchPipelineBlocks = 8; // Blocks decoded ahead of processing, and queued behind it for encoding
+
+// A worker's decode and encode threads. Each worker has its own, so one
+// file's decode, processing and encode run on three cores at once, and a
+// batch of a few long files still keeps the machine busy.
+struct RenderPipeline {
+    RenderPipeline() {
+        readThread.startThread();
+        writeThread.startThread();
+    }
+
+    ~RenderPipeline() {
+        readThread.stopThread(2000);
+        writeThread.stopThread(2000);
+    }
+
+    juce::TimeSliceThread readThread { "Pedalboard Render Reader" };
+    juce::TimeSliceThread writeThread { "Pedalboard Render Writer" };
+};
+
+// Streams one file through the worker's chain in fixed-size blocks, reading
+// ahead and writing behind on the pipeline's threads. With a cache and a
+// chainKey, an identical earlier render is copied instead.
+static bool renderFile(ProcessorWrapper* chain, RenderPipeline& pipeline, juce::AudioBuffer<float>& block,
+                       const char* inputPath, const char* outputPath, RenderCache* cache, const juce::String& chainKey) {
+    if (inputPath == nullptr || outputPath == nullptr) return false;
+
+    juce::File inputFile(inputPath);
+    std::unique_ptr<juce::AudioFormatReader> reader(g_internal->getFormatManager().createReaderFor(inputFile));
+    if (reader == nullptr) return false;
+
+    juce::File outputFile(outputPath);
+    juce::String renderKey;
+    if (cache != nullptr && chainKey.isNotEmpty()) {
+        renderKey = getRenderKey(chainKey, inputFile, reader->sampleRate, outputFile);
+        if (renderKey.isNotEmpty() && cache->fetch(renderKey, outputFile)) return true;
+    }
+
+    // Keep the source bit depth when the output format supports it
+    auto* format = g_internal->getFormatManager().findFormatForFileExtension(outputFile.getFileExtension());
+    if (format == nullptr) format = g_internal->getFormatManager().getDefaultFormat();
+    if (format == nullptr) return false;
+
+    const int numChannels = (int)reader->numChannels;
+    const int bitsPerSample = format->getPossibleBitDepths().contains((int)reader->bitsPerSample) ? (int)reader->bitsPerSample : 16;
+    // A failed render leaves any existing output alone
+    auto file = createFileWriter(outputFile, reader->sampleRate, numChannels, bitsPerSample, 0);
+    if (file == nullptr) return false;
+    auto writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(file->writer.release(), pipeline.writeThread,
+                                                                           batchBlockSize * batchPipelineBlocks);
+
+    // Takes ownership of the file reader; a read waits for the decoder rather than returning silence
+    juce::BufferingAudioReader input(reader.release(), pipeline.readThread, batchBlockSize * batchPipelineBlocks);
+    input.setReadTimeout(-1);
+
+    // Each file starts from a clean state; re-prepare only if the rate changed
+    if (chain->processor->getSampleRate() == input.sampleRate) {
+        chain->processor->reset();
+    }
+
+    block.setSize(numChannels, batchBlockSize, false, false, true);
+    for (juce::int64 pos = 0; pos < input.lengthInSamples; pos += batchBlockSize) {
+        const int numSamples = (int)juce::jmin((juce::int64)batchBlockSize, input.lengthInSamples - pos);
+        if (!input.read(&block, 0, numSamples, pos, true, true)) return false;
+
+        processWrapper(chain, block.getArrayOfWritePointers(), numChannels, numSamples, input.sampleRate);
+
+        // A full queue means encoding has fallen behind; wait for it rather than drop audio
+        while (!writer->write(block.getArrayOfReadPointers(), numSamples)) juce::Thread::sleep(1);
+    }
+
+    // Deleting the writer blocks until the queue is encoded and the file
+    // closed, so the output, and what the cache reads back, is complete
+    writer.reset();
+    if (!file->commit()) return false;
+    if (renderKey.isNotEmpty()) cache->store(renderKey, outputFile);
+    return true;
+}
+
+PedalboardRenderCache pedalboard_render_cache_create(int64_t max_memory_bytes, const char* directory) {
+    if (max_memory_bytes < 0) return nullptr;
+    pedalboard_init();
+    const auto cacheDirectory = directory != nullptr && directory[0] != 0 ? juce::File(juce::String::fromUTF8(directory)) : juce::File();
+    return static_cast<PedalboardRenderCache>(new RenderCache((size_t)max_memory_bytes, cacheDirectory));
+}
+
+void pedalboard_render_cache_free(PedalboardRenderCache cache) {
+    delete static_cast<RenderCache*>(cache);
+}
+
+void pedalboard_render_cache_clear(PedalboardRenderCache cache) {
+    if (cache) static_cast<RenderCache*>(cache)->clear();
+}
+
+void pedalboard_render_cache_get_stats(PedalboardRenderCache cache, PedalboardRenderCacheStats* stats) {
+    if (!cache || !stats) return;
+    static_cast<RenderCache*>(cache)->getStats(*stats);
+}
+
+int pedalboard_render_batch(PedalboardChain chain, const char** inputs, const char** outputs, int num_jobs, int num_threads, int* results) {
+    return pedalboard_render_batch_cached(chain, nullptr, inputs, outputs, num_jobs, num_threads, results);
+}
+
+int pedalboard_render_batch_cached(PedalboardChain chain, PedalboardRenderCache cache, const char** inputs, const char** outputs,
+                                   int num_jobs, int num_threads, int* results) {
+    if (num_jobs <= 0) return 0;
+    // Every job reads as failed unless a worker renders it, so an early
+    // return still leaves results filled in
+    if (results) std::fill(results, results + num_jobs, 0);
+    if (!chain || !inputs || !outputs) return 0;
+    pedalboard_init();
+
+    // The chain is hashed once; workers render copies of it in this state
+    auto* renderCache = static_cast<RenderCache*>(cache);
+    juce::String chainKey;
+    if (renderCache != nullptr) {
+        ContentHash hash;
+        if (hashProcessor(hash, static_cast<ProcessorWrapper*>(chain))) chainKey = hash.toString();
+    }
+
+    int numWorkers = num_threads > 0 ? num_threads : juce::SystemStats::getNumCpus();
+    numWorkers = juce::jlimit(1, num_jobs, numWorkers);
+
+    // Every worker runs its own copy of the chain, so no state is shared
+    std::vector<std::unique_ptr<ProcessorWrapper>> workerChains;
+    for (int i = 0; i < numWorkers; ++i) {
+        auto clone = cloneWrapper(static_cast<ProcessorWrapper*>(chain));
+        if (clone == nullptr) return 0;
+        workerChains.push_back(std::move(clone));
+    }
+
+    std::atomic<int> nextJob { 0 };
+    std::atomic<int> numSucceeded { 0 };
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.emplace_back([&, worker = workerChains[(size_t)i].get()] {
+            RenderPipeline pipeline;
+            juce::AudioBuffer<float> block;
+            for (int job = nextJob++; job < num_jobs; job = nextJob++) {
+                const bool ok = renderFile(worker, pipeline, block, inputs[job], outputs[job], renderCache, chainKey);
+                if (ok) ++numSucceeded;
+                if (results) results[job] = ok ? 1 : 0;
+            }
+        });
+    }
+
+    for (auto& worker : workers) worker.join();
+    return numSucceeded.load();
 }
 
 // --- Audio Stream ---
 class AudioStreamInternal : public juce::AudioIODeviceCallback {
 public:
-    AudioStreamInternal(ProcessorWrapper* proc) : processorWrapper(proc) {
-        juce::String error = deviceManager.initialiseWithDefaultDevices(2, 2);
+    AudioStreamInternal(ProcessorWrapper* proc) : processorWrapper(proc) {}
+
+    // Opens the configured devices, or the defaults when config is null.
+    // Returns an error message, or an empty string on success.
+    juce::String open(const PedalboardStreamConfig* config) {
+        const int numInputs = config != nullptr && config->num_input_channels > 0 ? config->num_input_channels : 2;
+        const int numOutputs = config != nullptr && config->num_output_channels > 0 ? config->num_output_channels : 2;
+
+        juce::String error = deviceManager.initialiseWithDefaultDevices(numInputs, numOutputs);
+        if (error.isNotEmpty() || config == nullptr) return error;
+
+        const juce::String inputName(config->input_device != nullptr ? config->input_device : "");
+        const juce::String outputName(config->output_device != nullptr ? config->output_device : "");
+
+        // Named devices are only found through the driver type that lists them
+        if (inputName.isNotEmpty() || outputName.isNotEmpty()) {
+            for (auto* type : deviceManager.getAvailableDeviceTypes()) {
+                type->scanForDevices();
+                if ((inputName.isEmpty() || type->getDeviceNames(true).contains(inputName))
+                    && (outputName.isEmpty() || type->getDeviceNames(false).contains(outputName))) {
+                    deviceManager.setCurrentAudioDeviceType(type->getTypeName(), true);
+                    break;
+                }
+            }
+        }
+
+        auto setup = deviceManager.getAudioDeviceSetup();
+        if (inputName.isNotEmpty()) setup.inputDeviceName = inputName;
+        if (outputName.isNotEmpty()) setup.outputDeviceName = outputName;
+        if (config->sample_rate > 0) setup.sampleRate = config->sample_rate;
+        if (config->buffer_size > 0) setup.bufferSize = config->buffer_size;
+        setup.useDefaultInputChannels = false;
+        setup.useDefaultOutputChannels = false;
+        setup.inputChannels.clear();
+        setup.inputChannels.setRange(0, numInputs, true);
+        setup.outputChannels.clear();
+        setup.outputChannels.setRange(0, numOutputs, true);
+
+        // The driver may round the rate and buffer size; get_info reports what was chosen
+        return deviceManager.setAudioDeviceSetup(setup, true);
+    }
+
+    void getStats(PedalboardStreamStats* stats) {
+        *stats = {};
+        stats->callbacks = callbacks.load(std::memory_order_relaxed);
+        stats->overruns = overruns.load(std::memory_order_relaxed);
+        stats->total_callback_ns = ticksToNanoseconds(totalTicks.load(std::memory_order_relaxed));
+        stats->max_callback_ns = ticksToNanoseconds(maxTicks.load(std::memory_order_relaxed));
+        stats->last_period_ns = lastPeriodNanos.load(std::memory_order_relaxed);
+        stats->max_load = maxLoad.load(std::memory_order_relaxed);
+
+        auto* device = deviceManager.getCurrentAudioDevice();
+        stats->xruns = device != nullptr ? device->getXRunCount() : -1;
+
+        // Percentiles report the upper edge of the histogram bucket they land in
+        juce::int64 counts[loadBuckets], total = 0;
+        for (int i = 0; i < loadBuckets; ++i) total += counts[i] = loadHistogram[(size_t)i].load(std::memory_order_relaxed);
+        if (total == 0) return;
+
+        auto percentile = [&](double fraction) {
+            const auto target = (juce::int64)std::ceil(fraction * (double)total);
+            juce::int64 seen = 0;
+            for (int i = 0; i < loadBuckets; ++i) {
+                seen += counts[i];
+                if (seen >= target) return (double)(i + 1) / (double)bucketsPerUnitLoad;
+            }
+            return (double)loadBuckets / (double)bucketsPerUnitLoad;
+        };
+        stats->p50_load = percentile(0.50);
+        stats->p95_load = percentile(0.95);
+        stats->p99_load = percentile(0.99);
+    }
+
+    void resetStats() {
+        callbacks.store(0);
+        overruns.store(0);
+        totalTicks.store(0);
+        maxTicks.store(0);
+        maxLoad.store(0.0);
+        for (auto& bucket : loadHistogram) bucket.store(0);
+    }
+
+    void getInfo(PedalboardStreamInfo* info) {
+        *info = {};
+        if (processorWrapper && processorWrapper->processor) {
+            info->processor_latency_samples = processorWrapper->processor->getLatencySamples();
+        }
+
+        auto* device = deviceManager.getCurrentAudioDevice();
+        if (device == nullptr) return;
+        info->sample_rate = device->getCurrentSampleRate();
+        info->buffer_size = device->getCurrentBufferSizeSamples();
+        info->num_input_channels = device->getActiveInputChannels().countNumberOfSetBits();
+        info->num_output_channels = device->getActiveOutputChannels().countNumberOfSetBits();
+        info->input_latency_samples = device->getInputLatencyInSamples();
+        info->output_latency_samples = device->getOutputLatencyInSamples();
     }
     ~AudioStreamInternal() {
         stop();
@@ -779,6 +5359,10 @@ public:
                                           int numOutputChannels,
                                           int numSamples,
                                           const juce::AudioIODeviceCallbackContext& context) override {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        inputObservers.observe(inputChannelData, numInputChannels, numSamples);
+
         juce::AudioBuffer<float> buffer(outputChannelData, numOutputChannels, numSamples);
         for (int i = 0; i < numOutputChannels; ++i) {
             if (i < numInputChannels && inputChannelData[i] != nullptr) {
@@ -788,13 +5372,21 @@ public:
             }
         }
         if (processorWrapper && processorWrapper->processor) {
-             processorWrapper->processor->processBlock(buffer, processorWrapper->midiBuffer);
+            if (autoBypass.load(std::memory_order_relaxed)) processorWrapper->processBlockOrBypass(buffer);
+            else processorWrapper->processBlock(buffer);
         }
+        outputObservers.observe(outputChannelData, numOutputChannels, numSamples);
+
+        recordCallback(juce::Time::getHighResolutionTicks() - start, numSamples);
     }
 
     void audioDeviceAboutToStart(juce::AudioIODevice* device) override {
+        currentSampleRate.store(device->getCurrentSampleRate());
         if (processorWrapper && processorWrapper->processor) {
-            processorWrapper->processor->prepareToPlay(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
+            prepareProcessor(*processorWrapper->processor,
+                             device->getCurrentSampleRate(),
+                             device->getCurrentBufferSizeSamples(),
+                             device->getActiveOutputChannels().countNumberOfSetBits());
         }
     }
 
@@ -808,13 +5400,110 @@ public:
     void stop() { deviceManager.removeAudioCallback(this); }
     juce::AudioDeviceManager deviceManager;
     ProcessorWrapper* processorWrapper;
+    std::atomic<bool> autoBypass { false };
+    ObserverSlots inputObservers;  // Device input, before processing
+    ObserverSlots outputObservers; // What the device plays
+
+private:
+    // Load is callback time over the buffer period; 1.0 means the deadline was hit exactly
+    static constexpr int bucketsPerUnitLoad = 20;
+    static constexpr int loadBuckets = 2 * bucketsPerUnitLoad; // The last bucket collects everything over 2x
+
+    // Called on the audio thread; only touches atomics.
+    void recordCallback(juce::int64 ticks, int numSamples) {
+        const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+        if (sampleRate <= 0) return;
+
+        const double periodSeconds = numSamples / sampleRate;
+        const double load = juce::Time::highResolutionTicksToSeconds(ticks) / periodSeconds;
+
+        callbacks.fetch_add(1, std::memory_order_relaxed);
+        totalTicks.fetch_add(ticks, std::memory_order_relaxed);
+        atomicMax(maxTicks, ticks);
+        if (load > 1.0) overruns.fetch_add(1, std::memory_order_relaxed);
+        lastPeriodNanos.store((juce::int64)(periodSeconds * 1.0e9), std::memory_order_relaxed);
+
+        auto currentMax = maxLoad.load(std::memory_order_relaxed);
+        while (load > currentMax && !maxLoad.compare_exchange_weak(currentMax, load, std::memory_order_relaxed)) {}
+
+        const int bucket = juce::jlimit(0, loadBuckets - 1, (int)(load * bucketsPerUnitLoad));
+        loadHistogram[(size_t)bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<double> currentSampleRate { 0.0 };
+    std::atomic<juce::int64> callbacks { 0 }, overruns { 0 }, totalTicks { 0 }, maxTicks { 0 }, lastPeriodNanos { 0 };
+    std::atomic<double> maxLoad { 0.0 };
+    std::array<std::atomic<juce::int64>, loadBuckets> loadHistogram {};
 };
 
 PedalboardAudioStream pedalboard_create_audio_stream(PedalboardProcessor processor) {
+    return pedalboard_create_audio_stream_with_config(processor, nullptr);
+}
+
+PedalboardAudioStream pedalboard_create_audio_stream_with_config(PedalboardProcessor processor, const PedalboardStreamConfig* config) {
     pedalboard_init();
     if (!processor) return nullptr;
-    auto* wrapper = static_cast<ProcessorWrapper*>(processor);
-    return new AudioStreamInternal(wrapper);
+    auto stream = std::make_unique<AudioStreamInternal>(static_cast<ProcessorWrapper*>(processor));
+    if (stream->open(config).isNotEmpty()) return nullptr;
+    return static_cast<PedalboardAudioStream>(stream.release());
+}
+
+void pedalboard_audio_stream_get_stats(PedalboardAudioStream stream, PedalboardStreamStats* stats) {
+    if (!stream || !stats) return;
+    static_cast<AudioStreamInternal*>(stream)->getStats(stats);
+}
+
+void pedalboard_audio_stream_reset_stats(PedalboardAudioStream stream) {
+    if (stream) static_cast<AudioStreamInternal*>(stream)->resetStats();
+}
+
+void pedalboard_audio_stream_set_input_tap(PedalboardAudioStream stream, PedalboardAudioTap tap) {
+    if (stream) static_cast<AudioStreamInternal*>(stream)->inputObservers.setTap(static_cast<AudioTap*>(tap));
+}
+
+void pedalboard_audio_stream_set_output_tap(PedalboardAudioStream stream, PedalboardAudioTap tap) {
+    if (stream) static_cast<AudioStreamInternal*>(stream)->outputObservers.setTap(static_cast<AudioTap*>(tap));
+}
+
+void pedalboard_audio_stream_set_auto_bypass(PedalboardAudioStream stream, int enabled) {
+    if (stream) static_cast<AudioStreamInternal*>(stream)->autoBypass.store(enabled != 0, std::memory_order_relaxed);
+}
+
+void pedalboard_audio_stream_get_info(PedalboardAudioStream stream, PedalboardStreamInfo* info) {
+    if (!stream || !info) return;
+    static_cast<AudioStreamInternal*>(stream)->getInfo(info);
+}
+
+char** pedalboard_get_audio_device_names(int is_input, int* num_devices) {
+    pedalboard_init();
+    if (num_devices) *num_devices = 0;
+
+    // Every driver type can list devices; names shared by several appear once
+    juce::AudioDeviceManager manager;
+    juce::StringArray names;
+    for (auto* type : manager.getAvailableDeviceTypes()) {
+        type->scanForDevices();
+        names.addArray(type->getDeviceNames(is_input != 0));
+    }
+    names.removeDuplicates(false);
+    if (names.isEmpty()) return nullptr;
+
+    auto** result = static_cast<char**>(std::malloc(sizeof(char*) * (size_t)names.size()));
+    if (result == nullptr) return nullptr;
+    for (int i = 0; i < names.size(); ++i) {
+        const auto* utf8 = names[i].toRawUTF8();
+        const size_t size = std::strlen(utf8) + 1;
+        result[i] = static_cast<char*>(std::malloc(size));
+        if (result[i] != nullptr) std::memcpy(result[i], utf8, size);
+    }
+    if (num_devices) *num_devices = names.size();
+    return result;
+}
+
+void pedalboard_free_device_names(char** names, int num_devices) {
+    if (!names) return;
+    for (int i = 0; i < num_devices; ++i) std::free(names[i]);
+    std::free(names);
 }
 
 void pedalboard_audio_stream_start(PedalboardAudioStream stream) {
@@ -10,10 +10,17 @@ package pedalboard
 import "C"
 import (
 	"fmt"
+	"io"
 	"runtime"
+	"time"
 	"unsafe"
 )
 
+// Creates the bridge's shared state, including JUCE's message manager, on
+// the thread running package initialisation, which is the main thread.
+// Plugins and audio devices expect that thread to stay the message thread.
+// Audio and plugin formats are registered on first use, so importing the
+// package stays cheap.
 func init() {
 	C.pedalboard_init()
 }
@@ -21,7 +28,10 @@ func init() {
 // Processor represents an audio processor (internal effect or external plugin).
 // It wraps a JUCE AudioProcessor instance.
 type Processor struct {
-	handle C.PedalboardProcessor
+	handle   C.PedalboardProcessor
+	owner    interface{} // Keeps the owning object alive for borrowed handles
+	analyzer *Analyzer   // Keeps an attached analyzer alive
+	tap      *AudioTap   // Keeps an attached tap alive
 }
 
 // NewInternalProcessor creates a new internal processor by name.
@@ -39,6 +49,59 @@ func NewInternalProcessor(name string) (*Processor, error) {
 	return wrapProcessor(handle), nil
 }
 
+// InternalProcessorNames returns the names accepted by NewInternalProcessor.
+func InternalProcessorNames() []string {
+	names := make([]string, int(C.pedalboard_get_num_internal_processors()))
+	for i := range names {
+		names[i] = C.GoString(C.pedalboard_get_internal_processor_name(C.int(i)))
+	}
+	return names
+}
+
+// NewFusedChain creates a single processor running the named internal
+// processors in order. The stages are bound at compile time rather than
+// called through the processor interface, and a block goes through all of
+// them a short chunk at a time, so the samples stay in cache between
+// stages. Only the sequences listed by FusedChainPresets are available.
+// Parameters are indexed across every stage in order.
+func NewFusedChain(names ...string) (*Processor, error) {
+	if len(names) == 0 {
+		return nil, fmt.Errorf("fused chain needs at least one stage")
+	}
+	cNames := (**C.char)(C.malloc(C.size_t(len(names)) * C.size_t(unsafe.Sizeof((*C.char)(nil)))))
+	defer C.free(unsafe.Pointer(cNames))
+
+	nameSlice := unsafe.Slice(cNames, len(names))
+	for i, name := range names {
+		nameSlice[i] = C.CString(name)
+	}
+	defer func() {
+		for i := range nameSlice {
+			C.free(unsafe.Pointer(nameSlice[i]))
+		}
+	}()
+
+	handle := C.pedalboard_create_fused_chain(cNames, C.int(len(names)))
+	if handle == nil {
+		return nil, fmt.Errorf("no fused chain preset for %v", names)
+	}
+	return wrapProcessor(handle), nil
+}
+
+// FusedChainPresets returns the stage sequences NewFusedChain accepts.
+func FusedChainPresets() [][]string {
+	const maxStages = 8
+	var cNames [maxStages]*C.char
+	presets := make([][]string, int(C.pedalboard_get_num_fused_chain_presets()))
+	for i := range presets {
+		count := int(C.pedalboard_get_fused_chain_preset(C.int(i), &cNames[0], maxStages))
+		for _, name := range cNames[:min(count, maxStages)] {
+			presets[i] = append(presets[i], C.GoString(name))
+		}
+	}
+	return presets
+}
+
 // LoadPlugin loads a VST3 or AU plugin from the specified file path.
 // path: The absolute path to the plugin file (e.g., .vst3 or .component).
 // Returns a pointer to the Processor or an error if loading failed.
@@ -54,6 +117,33 @@ func LoadPlugin(path string) (*Processor, error) {
 	return wrapProcessor(handle), nil
 }
 
+// SetPluginCacheFile sets a file used to persist plugin scan results, so
+// LoadPlugin can skip scanning plugins it has already seen in earlier runs.
+// The file is loaded now if it exists, and rewritten whenever new plugins are scanned.
+func SetPluginCacheFile(path string) error {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+
+	if C.pedalboard_set_plugin_cache_file(cPath) == 0 {
+		return fmt.Errorf("failed to read plugin cache: %s", path)
+	}
+	return nil
+}
+
+// ScanPlugins scans a directory recursively and caches every plugin it finds,
+// so later LoadPlugin calls for those files don't scan them again.
+// Returns the number of plugin types cached for the directory.
+func ScanPlugins(dir string) (int, error) {
+	cDir := C.CString(dir)
+	defer C.free(unsafe.Pointer(cDir))
+
+	n := int(C.pedalboard_scan_plugins(cDir))
+	if n == 0 {
+		return 0, fmt.Errorf("no plugins found in: %s", dir)
+	}
+	return n, nil
+}
+
 func wrapProcessor(handle C.PedalboardProcessor) *Processor {
 	p := &Processor{handle: handle}
 	runtime.SetFinalizer(p, func(obj *Processor) {
@@ -74,39 +164,76 @@ type AudioBuffer struct {
 // path: The path to the audio file.
 // Returns an AudioBuffer or an error if loading failed.
 func LoadAudioFile(path string) (*AudioBuffer, error) {
-	cPath := C.CString(path)
-	defer C.free(unsafe.Pointer(cPath))
-
-	cBuffer := C.pedalboard_load_audio_file(cPath)
-	if cBuffer == nil {
+	reader, err := OpenAudioReader(path)
+	if err != nil {
 		return nil, fmt.Errorf("failed to load audio file: %s", path)
 	}
-	defer C.pedalboard_audio_buffer_free(cBuffer)
-
-	numChannels := int(cBuffer.num_channels)
-	numSamples := int(cBuffer.num_samples)
-	sampleRate := float64(cBuffer.sample_rate)
+	defer reader.Close()
 
-	data := make([][]float32, numChannels)
-	cChannelData := unsafe.Slice(cBuffer.data, numChannels)
-	for i := 0; i < numChannels; i++ {
+	numSamples := int(reader.NumSamples)
+	data := make([][]float32, reader.NumChannels)
+	for i := range data {
 		data[i] = make([]float32, numSamples)
-		// Copy data from C to Go
-		src := unsafe.Slice((*float32)(unsafe.Pointer(cChannelData[i])), numSamples)
-		copy(data[i], src)
+	}
+
+	// Decode straight into the Go slices, one chunk at a time
+	const chunkSize = 65536
+	chunk := make([][]float32, reader.NumChannels)
+	for pos := 0; pos < numSamples; pos += chunkSize {
+		end := pos + chunkSize
+		if end > numSamples {
+			end = numSamples
+		}
+		for i := range chunk {
+			chunk[i] = data[i][pos:end]
+		}
+		if _, err := reader.Read(chunk); err != nil {
+			return nil, fmt.Errorf("failed to load audio file: %s", path)
+		}
 	}
 
 	return &AudioBuffer{
 		Data:       data,
-		SampleRate: sampleRate,
+		SampleRate: reader.SampleRate,
 	}, nil
 }
 
-// SaveAudioFile saves an AudioBuffer to a file.
+// WriterOptions controls how audio files are encoded. The zero value writes
+// 16-bit audio synchronously, at the format's first quality setting.
+type WriterOptions struct {
+	// BitsPerSample is 16, 24 or 32 (float for WAV); 0 uses 16.
+	BitsPerSample int
+	// Quality indexes the format's quality options, such as the FLAC
+	// compression level (0-8) or the Ogg Vorbis bitrate step.
+	Quality int
+	// Threaded encodes and writes on a background thread, so Write only
+	// copies into a FIFO. It has no effect when saving a whole buffer.
+	Threaded bool
+	// BufferSamples is the FIFO length per channel for threaded writers; 0 uses 65536.
+	BufferSamples int
+}
+
+func (o WriterOptions) toC() C.PedalboardAudioWriterOptions {
+	var options C.PedalboardAudioWriterOptions
+	options.bits_per_sample = C.int(o.BitsPerSample)
+	options.quality = C.int(o.Quality)
+	if o.Threaded {
+		options.threaded = 1
+	}
+	options.buffer_samples = C.int(o.BufferSamples)
+	return options
+}
+
+// SaveAudioFile saves an AudioBuffer to a file as 16-bit audio.
 // path: The output file path. Format is determined by extension (e.g., .wav, .aiff).
 // buffer: The AudioBuffer to save.
 // Returns an error if saving failed.
 func SaveAudioFile(path string, buffer *AudioBuffer) error {
+	return SaveAudioFileWithOptions(path, buffer, WriterOptions{})
+}
+
+// SaveAudioFileWithOptions saves an AudioBuffer with the given bit depth and quality.
+func SaveAudioFileWithOptions(path string, buffer *AudioBuffer, options WriterOptions) error {
 	cPath := C.CString(path)
 	defer C.free(unsafe.Pointer(cPath))
 
@@ -116,131 +243,1588 @@ func SaveAudioFile(path string, buffer *AudioBuffer) error {
 	}
 	numSamples := len(buffer.Data[0])
 
-	// Create C buffer structure
+	cPtrs := channelPointers(buffer.Data)
+	if cPtrs == nil {
+		return fmt.Errorf("failed to allocate memory")
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+
 	var cBuffer C.PedalboardAudioBuffer
+	cBuffer.data = cPtrs
 	cBuffer.num_channels = C.int(numChannels)
 	cBuffer.num_samples = C.int(numSamples)
 	cBuffer.sample_rate = C.double(buffer.SampleRate)
 
-	// Allocate pointer array for C
-	cData := (**C.float)(C.malloc(C.size_t(numChannels) * C.size_t(unsafe.Sizeof((*C.float)(nil)))))
-	if cData == nil {
-		return fmt.Errorf("failed to allocate memory")
+	cOptions := options.toC()
+	if C.pedalboard_save_audio_file_with_options(cPath, &cBuffer, &cOptions) == 0 {
+		return fmt.Errorf("failed to save audio file: %s", path)
+	}
+	return nil
+}
+
+// NativeAudioBuffer is a multi-channel audio buffer backed by a single
+// contiguous C allocation. Processors and file IO use it without copying.
+// Data slices point into C memory and are only valid until Free is called
+// (or, if Free is never called, while the NativeAudioBuffer is reachable).
+type NativeAudioBuffer struct {
+	buffer *C.PedalboardAudioBuffer
+	// Data holds the audio samples as [channel][sample], viewing C memory.
+	Data [][]float32
+	// SampleRate is the sample rate of the audio data in Hz.
+	SampleRate float64
+}
+
+// NewNativeAudioBuffer allocates a zero-filled native buffer.
+func NewNativeAudioBuffer(numChannels, numSamples int, sampleRate float64) (*NativeAudioBuffer, error) {
+	cBuffer := C.pedalboard_audio_buffer_create(C.int(numChannels), C.int(numSamples), C.double(sampleRate))
+	if cBuffer == nil {
+		return nil, fmt.Errorf("failed to allocate %d x %d native buffer", numChannels, numSamples)
+	}
+	return wrapNativeAudioBuffer(cBuffer), nil
+}
+
+// LoadNativeAudioFile loads an audio file into a NativeAudioBuffer.
+// Unlike LoadAudioFile, the samples stay in the C allocation they were decoded into.
+func LoadNativeAudioFile(path string) (*NativeAudioBuffer, error) {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+
+	cBuffer := C.pedalboard_load_audio_file(cPath)
+	if cBuffer == nil {
+		return nil, fmt.Errorf("failed to load audio file: %s", path)
 	}
-	
-	cDataSlice := unsafe.Slice(cData, numChannels)
-	
+	return wrapNativeAudioBuffer(cBuffer), nil
+}
+
+func wrapNativeAudioBuffer(cBuffer *C.PedalboardAudioBuffer) *NativeAudioBuffer {
+	numChannels := int(cBuffer.num_channels)
+	numSamples := int(cBuffer.num_samples)
+
+	data := make([][]float32, numChannels)
+	cChannelData := unsafe.Slice(cBuffer.data, numChannels)
 	for i := 0; i < numChannels; i++ {
-		cDataSlice[i] = (*C.float)(unsafe.Pointer(&buffer.Data[i][0]))
+		data[i] = unsafe.Slice((*float32)(unsafe.Pointer(cChannelData[i])), numSamples)
+	}
+
+	b := &NativeAudioBuffer{
+		buffer:     cBuffer,
+		Data:       data,
+		SampleRate: float64(cBuffer.sample_rate),
 	}
-	cBuffer.data = cData
+	runtime.SetFinalizer(b, (*NativeAudioBuffer).Free)
+	return b
+}
 
-	C.pedalboard_save_audio_file(cPath, &cBuffer)
-	
-	C.free(unsafe.Pointer(cData))
+// NumChannels returns the number of channels in the buffer.
+func (b *NativeAudioBuffer) NumChannels() int {
+	return len(b.Data)
+}
 
-	return nil
+// NumSamples returns the number of samples per channel.
+func (b *NativeAudioBuffer) NumSamples() int {
+	if len(b.Data) == 0 {
+		return 0
+	}
+	return len(b.Data[0])
 }
 
-// Process processes a block of audio data through the processor.
-// buffer: The audio data to process (modified in-place).
-// sampleRate: The sample rate of the audio data.
-func (p *Processor) Process(buffer [][]float32, sampleRate float64) {
-	numChannels := len(buffer)
-	if numChannels == 0 {
+// Free releases the C memory. Data must not be used afterwards.
+// It is safe to call more than once.
+func (b *NativeAudioBuffer) Free() {
+	if b.buffer == nil {
 		return
 	}
-	numSamples := len(buffer[0])
+	C.pedalboard_audio_buffer_free(b.buffer)
+	b.buffer = nil
+	b.Data = nil
+	runtime.SetFinalizer(b, nil)
+}
 
-	// Allocate pointer array in C memory to avoid CGO pointer rules violation
-	// (Go pointer to Go pointer in a C call).
-	cPtrs := (**C.float)(C.malloc(C.size_t(numChannels) * C.size_t(unsafe.Sizeof((*C.float)(nil)))))
+// SaveNativeAudioFile saves a NativeAudioBuffer to a file without copying it.
+func SaveNativeAudioFile(path string, buffer *NativeAudioBuffer) error {
+	if buffer.buffer == nil {
+		return fmt.Errorf("buffer has been freed")
+	}
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+
+	buffer.buffer.sample_rate = C.double(buffer.SampleRate)
+	ok := C.pedalboard_save_audio_file_with_options(cPath, buffer.buffer, nil)
+	runtime.KeepAlive(buffer)
+	if ok == 0 {
+		return fmt.Errorf("failed to save audio file: %s", path)
+	}
+	return nil
+}
+
+// SampleFormat is the sample type of a CompactAudioBuffer.
+type SampleFormat int
+
+const (
+	// SampleInt16 holds 16-bit integers, clipping at full scale.
+	SampleInt16 SampleFormat = C.PEDALBOARD_SAMPLE_INT16
+	// SampleFloat16 holds IEEE half floats, which keep levels above full scale.
+	SampleFloat16 SampleFormat = C.PEDALBOARD_SAMPLE_FLOAT16
+)
+
+// CompactAudioBuffer holds planar 16-bit audio in C memory, half the size of
+// a float32 buffer, for keeping large sets of clips in memory. Processors
+// consume it directly, converting one block at a time to float and back.
+type CompactAudioBuffer struct {
+	buffer *C.PedalboardCompactAudioBuffer
+	// SampleRate is the sample rate of the audio data in Hz.
+	SampleRate float64
+}
+
+// NewCompactAudioBuffer allocates a silent compact buffer.
+func NewCompactAudioBuffer(format SampleFormat, numChannels, numSamples int, sampleRate float64) (*CompactAudioBuffer, error) {
+	cBuffer := C.pedalboard_compact_buffer_create(C.int(format), C.int(numChannels), C.int(numSamples), C.double(sampleRate))
+	if cBuffer == nil {
+		return nil, fmt.Errorf("failed to allocate %d x %d compact buffer", numChannels, numSamples)
+	}
+	return wrapCompactAudioBuffer(cBuffer), nil
+}
+
+// LoadCompactAudioFile loads an audio file straight into a compact buffer,
+// without ever holding the whole file as float.
+func LoadCompactAudioFile(path string, format SampleFormat) (*CompactAudioBuffer, error) {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+
+	cBuffer := C.pedalboard_load_audio_file_compact(cPath, C.int(format))
+	if cBuffer == nil {
+		return nil, fmt.Errorf("failed to load audio file: %s", path)
+	}
+	return wrapCompactAudioBuffer(cBuffer), nil
+}
+
+// NewCompactAudioBufferFrom converts an AudioBuffer to a compact buffer.
+func NewCompactAudioBufferFrom(buffer *AudioBuffer, format SampleFormat) (*CompactAudioBuffer, error) {
+	if len(buffer.Data) == 0 {
+		return nil, fmt.Errorf("buffer has no channels")
+	}
+	b, err := NewCompactAudioBuffer(format, len(buffer.Data), len(buffer.Data[0]), buffer.SampleRate)
+	if err != nil {
+		return nil, err
+	}
+	if err := b.Write(buffer.Data, 0); err != nil {
+		b.Free()
+		return nil, err
+	}
+	return b, nil
+}
+
+func wrapCompactAudioBuffer(cBuffer *C.PedalboardCompactAudioBuffer) *CompactAudioBuffer {
+	b := &CompactAudioBuffer{buffer: cBuffer, SampleRate: float64(cBuffer.sample_rate)}
+	runtime.SetFinalizer(b, (*CompactAudioBuffer).Free)
+	return b
+}
+
+// NumChannels returns the number of channels in the buffer.
+func (b *CompactAudioBuffer) NumChannels() int {
+	if b.buffer == nil {
+		return 0
+	}
+	return int(b.buffer.num_channels)
+}
+
+// NumSamples returns the number of samples per channel.
+func (b *CompactAudioBuffer) NumSamples() int {
+	if b.buffer == nil {
+		return 0
+	}
+	return int(b.buffer.num_samples)
+}
+
+// Format returns the buffer's sample type.
+func (b *CompactAudioBuffer) Format() SampleFormat {
+	return SampleFormat(b.buffer.format)
+}
+
+// Read decodes len(dest[0]) samples from each of the first len(dest)
+// channels, starting at sample start, into dest.
+func (b *CompactAudioBuffer) Read(dest [][]float32, start int) error {
+	if len(dest) == 0 || len(dest[0]) == 0 {
+		return nil
+	}
+	cPtrs := channelPointers(dest)
 	if cPtrs == nil {
-		return
+		return fmt.Errorf("failed to allocate channel pointers")
 	}
 	defer C.free(unsafe.Pointer(cPtrs))
+	if C.pedalboard_compact_buffer_read(b.buffer, cPtrs, C.int(len(dest)), C.int(start), C.int(len(dest[0]))) == 0 {
+		return fmt.Errorf("read of %d x %d samples at %d is out of range", len(dest), len(dest[0]), start)
+	}
+	return nil
+}
 
-	cPtrsSlice := unsafe.Slice(cPtrs, numChannels)
-	for i := 0; i < numChannels; i++ {
-		cPtrsSlice[i] = (*C.float)(unsafe.Pointer(&buffer[i][0]))
+// Write encodes src into the buffer's first len(src) channels, starting
+// at sample start.
+func (b *CompactAudioBuffer) Write(src [][]float32, start int) error {
+	if len(src) == 0 || len(src[0]) == 0 {
+		return nil
+	}
+	cPtrs := channelPointers(src)
+	if cPtrs == nil {
+		return fmt.Errorf("failed to allocate channel pointers")
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+	if C.pedalboard_compact_buffer_write(b.buffer, cPtrs, C.int(len(src)), C.int(start), C.int(len(src[0]))) == 0 {
+		return fmt.Errorf("write of %d x %d samples at %d is out of range", len(src), len(src[0]), start)
 	}
+	return nil
+}
 
-	C.pedalboard_processor_process(
-		p.handle,
-		cPtrs,
-		C.int(numChannels),
-		C.int(numSamples),
-		C.double(sampleRate),
-	)
+// ToAudioBuffer decodes the whole buffer into a new float32 AudioBuffer.
+func (b *CompactAudioBuffer) ToAudioBuffer() (*AudioBuffer, error) {
+	data := make([][]float32, b.NumChannels())
+	for i := range data {
+		data[i] = make([]float32, b.NumSamples())
+	}
+	if err := b.Read(data, 0); err != nil {
+		return nil, err
+	}
+	return &AudioBuffer{Data: data, SampleRate: b.SampleRate}, nil
 }
 
-// SetParameter sets a parameter value for the processor.
-// index: The 0-based index of the parameter.
-// value: The new value (typically normalized 0.0 to 1.0).
-func (p *Processor) SetParameter(index int, value float32) {
-	C.pedalboard_processor_set_parameter(p.handle, C.int(index), C.float(value))
+// Free releases the C memory. It is safe to call more than once.
+func (b *CompactAudioBuffer) Free() {
+	if b.buffer == nil {
+		return
+	}
+	C.pedalboard_compact_buffer_free(b.buffer)
+	b.buffer = nil
+	runtime.SetFinalizer(b, nil)
 }
 
-// GetParameter returns the current value of a parameter.
-// index: The 0-based index of the parameter.
-// Returns the parameter value.
-func (p *Processor) GetParameter(index int) float32 {
-	return float32(C.pedalboard_processor_get_parameter(p.handle, C.int(index)))
+// AudioReader reads an audio file incrementally, in caller-sized chunks.
+type AudioReader struct {
+	handle C.PedalboardAudioReader
+	// NumChannels is the number of channels in the file.
+	NumChannels int
+	// NumSamples is the length of the file in samples per channel.
+	NumSamples int64
+	// SampleRate is the sample rate of the file in Hz.
+	SampleRate float64
+	// BitsPerSample is the bit depth the file is stored at.
+	BitsPerSample int
 }
 
-// NumParameters returns the total number of parameters available in the processor.
-func (p *Processor) NumParameters() int {
-	return int(C.pedalboard_processor_get_num_parameters(p.handle))
+// OpenAudioReader opens an audio file for chunked reading.
+// path: The path to the audio file.
+// Returns an AudioReader or an error if the file could not be opened.
+func OpenAudioReader(path string) (*AudioReader, error) {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+	return newAudioReader(C.pedalboard_audio_reader_open(cPath), path)
 }
 
-// AudioStream represents a live audio stream processing audio from default input to output.
-type AudioStream struct {
-	handle    C.PedalboardAudioStream
-	processor *Processor // Keep reference to prevent GC
+// OpenMappedAudioReader opens a WAV or AIFF file through a memory mapping.
+// SeekTo costs nothing, only the sections that are read are loaded from
+// disk, and processes reading the same file share its page cache. Other
+// formats are opened as with OpenAudioReader; see Mapped.
+func OpenMappedAudioReader(path string) (*AudioReader, error) {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+	return newAudioReader(C.pedalboard_audio_reader_open_mapped(cPath), path)
 }
 
-// NewAudioStream creates a new audio stream using the specified processor.
-// It opens the default audio input and output devices.
-// processor: The processor to apply to the audio stream.
-// Returns the AudioStream instance or an error.
-func NewAudioStream(processor *Processor) (*AudioStream, error) {
-	handle := C.pedalboard_create_audio_stream(processor.handle)
+func newAudioReader(handle C.PedalboardAudioReader, path string) (*AudioReader, error) {
 	if handle == nil {
-		return nil, fmt.Errorf("failed to create audio stream")
+		return nil, fmt.Errorf("failed to open audio file: %s", path)
 	}
-	return &AudioStream{handle: handle, processor: processor}, nil
+
+	var info C.PedalboardAudioFileInfo
+	C.pedalboard_audio_reader_get_info(handle, &info)
+
+	r := &AudioReader{
+		handle:        handle,
+		NumChannels:   int(info.num_channels),
+		NumSamples:    int64(info.num_samples),
+		SampleRate:    float64(info.sample_rate),
+		BitsPerSample: int(info.bits_per_sample),
+	}
+	runtime.SetFinalizer(r, (*AudioReader).Close)
+	return r, nil
 }
 
-// Start starts the audio processing on the stream.
-func (s *AudioStream) Start() {
-	C.pedalboard_audio_stream_start(s.handle)
+// OpenResampledAudioReader opens an audio file and converts it to sampleRate
+// as it is read. NumSamples, SampleRate and positions refer to the converted audio.
+func OpenResampledAudioReader(path string, sampleRate float64) (*AudioReader, error) {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+	return newAudioReader(C.pedalboard_audio_reader_open_resampled(cPath, C.double(sampleRate)), path)
 }
 
-// Stop stops the audio processing on the stream.
-func (s *AudioStream) Stop() {
-	C.pedalboard_audio_stream_stop(s.handle)
+// Mapped reports whether the reader reads through a memory mapping.
+func (r *AudioReader) Mapped() bool {
+	return C.pedalboard_audio_reader_is_mapped(r.handle) != 0
 }
 
-// Close releases the audio stream resources.
-func (s *AudioStream) Close() {
-	C.pedalboard_audio_stream_free(s.handle)
+// Read reads up to len(buffer[0]) samples per channel from the current position.
+// Returns the number of samples read, or io.EOF once the end of the file is reached.
+func (r *AudioReader) Read(buffer [][]float32) (int, error) {
+	if len(buffer) == 0 || len(buffer[0]) == 0 {
+		return 0, nil
+	}
+
+	cPtrs := channelPointers(buffer)
+	if cPtrs == nil {
+		return 0, fmt.Errorf("failed to allocate memory")
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+
+	n := int(C.pedalboard_audio_reader_read(r.handle, cPtrs, C.int(len(buffer)), C.int(len(buffer[0]))))
+	if n == 0 {
+		return 0, io.EOF
+	}
+	return n, nil
 }
 
-// GetInputDevices returns a list of available input device names.
-// Currently returns a dummy list.
-func GetInputDevices() ([]string, error) {
-	return []string{"Default Input"}, nil
+// SeekTo moves the read position to the given sample.
+func (r *AudioReader) SeekTo(position int64) error {
+	if C.pedalboard_audio_reader_seek(r.handle, C.int64_t(position)) == 0 {
+		return fmt.Errorf("invalid seek position %d", position)
+	}
+	return nil
 }
 
-// GetOutputDevices returns a list of available output device names.
-// Currently returns a dummy list.
-func GetOutputDevices() ([]string, error) {
-	return []string{"Default Output"}, nil
+// Position returns the current read position in samples.
+func (r *AudioReader) Position() int64 {
+	return int64(C.pedalboard_audio_reader_get_position(r.handle))
 }
 
-// NewAudioStreamWithDevices creates a new audio stream using the specified processor and devices.
-// Currently ignores device names and uses defaults.
-func NewAudioStreamWithDevices(processor *Processor, inputDevice, outputDevice string) (*AudioStream, error) {
-	// TODO: Implement device selection in C++ layer
-	return NewAudioStream(processor)
-}
\ No newline at end of file
+// Close releases the reader. It is safe to call more than once.
+func (r *AudioReader) Close() {
+	if r.handle == nil {
+		return
+	}
+	C.pedalboard_audio_reader_close(r.handle)
+	r.handle = nil
+	runtime.SetFinalizer(r, nil)
+}
+
+// AudioWriter writes an audio file incrementally, in caller-sized chunks.
+type AudioWriter struct {
+	handle      C.PedalboardAudioWriter
+	numChannels int
+}
+
+// CreateAudioWriter creates an audio file for chunked writing. An existing
+// file at path is replaced when the writer is closed, and kept if opening fails.
+// path: The output file path. Format is determined by extension (e.g., .wav, .aiff).
+// bitsPerSample: The bit depth to write; 0 uses 16.
+// Returns an AudioWriter or an error if the file could not be created.
+func CreateAudioWriter(path string, sampleRate float64, numChannels, bitsPerSample int) (*AudioWriter, error) {
+	return CreateAudioWriterWithOptions(path, sampleRate, numChannels, WriterOptions{BitsPerSample: bitsPerSample})
+}
+
+// CreateAudioWriterWithOptions creates an audio file writer with the given
+// bit depth, quality and threading. With Threaded set, encoding overlaps
+// with whatever the caller does between writes; Close waits for it to finish.
+func CreateAudioWriterWithOptions(path string, sampleRate float64, numChannels int, options WriterOptions) (*AudioWriter, error) {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+
+	cOptions := options.toC()
+	handle := C.pedalboard_audio_writer_open_with_options(cPath, C.double(sampleRate), C.int(numChannels), &cOptions)
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create audio file: %s", path)
+	}
+
+	w := &AudioWriter{handle: handle, numChannels: numChannels}
+	runtime.SetFinalizer(w, (*AudioWriter).Close)
+	return w, nil
+}
+
+// Write appends a chunk of audio to the file.
+func (w *AudioWriter) Write(buffer [][]float32) error {
+	if len(buffer) < w.numChannels {
+		return fmt.Errorf("expected %d channels, got %d", w.numChannels, len(buffer))
+	}
+	if len(buffer[0]) == 0 {
+		return nil
+	}
+
+	cPtrs := channelPointers(buffer)
+	if cPtrs == nil {
+		return fmt.Errorf("failed to allocate memory")
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+
+	if C.pedalboard_audio_writer_write(w.handle, cPtrs, C.int(len(buffer)), C.int(len(buffer[0]))) == 0 {
+		return fmt.Errorf("failed to write audio")
+	}
+	return nil
+}
+
+// Close flushes and closes the file, then moves it into place. It returns
+// an error if that move fails, in which case no file is written. It is safe
+// to call more than once.
+func (w *AudioWriter) Close() error {
+	if w.handle == nil {
+		return nil
+	}
+	ok := C.pedalboard_audio_writer_close(w.handle) != 0
+	w.handle = nil
+	runtime.SetFinalizer(w, nil)
+	if !ok {
+		return fmt.Errorf("failed to move the written file into place")
+	}
+	return nil
+}
+
+// Process processes a block of audio data through the processor.
+// buffer: The audio data to process (modified in-place).
+// sampleRate: The sample rate of the audio data.
+func (p *Processor) Process(buffer [][]float32, sampleRate float64) {
+	numChannels := len(buffer)
+	if numChannels == 0 {
+		return
+	}
+	numSamples := len(buffer[0])
+
+	cPtrs := channelPointers(buffer)
+	if cPtrs == nil {
+		return
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+
+	C.pedalboard_processor_process(
+		p.handle,
+		cPtrs,
+		C.int(numChannels),
+		C.int(numSamples),
+		C.double(sampleRate),
+	)
+}
+
+// channelPointers builds a C array of channel pointers for buffer.
+// The array is allocated in C memory to avoid CGO pointer rules violation
+// (Go pointer to Go pointer in a C call). The caller must free it.
+func channelPointers(buffer [][]float32) **C.float {
+	numChannels := len(buffer)
+	cPtrs := (**C.float)(C.malloc(C.size_t(numChannels) * C.size_t(unsafe.Sizeof((*C.float)(nil)))))
+	if cPtrs == nil {
+		return nil
+	}
+
+	cPtrsSlice := unsafe.Slice(cPtrs, numChannels)
+	for i := 0; i < numChannels; i++ {
+		cPtrsSlice[i] = (*C.float)(unsafe.Pointer(&buffer[i][0]))
+	}
+	return cPtrs
+}
+
+// ProcessNative processes a NativeAudioBuffer in-place, passing its
+// channel pointers straight to C.
+func (p *Processor) ProcessNative(buffer *NativeAudioBuffer) {
+	if buffer.buffer == nil {
+		return
+	}
+	C.pedalboard_processor_process(
+		p.handle,
+		buffer.buffer.data,
+		buffer.buffer.num_channels,
+		buffer.buffer.num_samples,
+		C.double(buffer.SampleRate),
+	)
+	runtime.KeepAlive(buffer)
+}
+
+// ProcessCompact processes a CompactAudioBuffer in-place, converting one
+// block at a time to float and back in native code.
+func (p *Processor) ProcessCompact(buffer *CompactAudioBuffer) {
+	if buffer.buffer == nil {
+		return
+	}
+	buffer.buffer.sample_rate = C.double(buffer.SampleRate)
+	C.pedalboard_processor_process_compact(p.handle, buffer.buffer)
+	runtime.KeepAlive(buffer)
+}
+
+// ProcessContext processes audio through one processor without per-call
+// allocation. It owns a persistent C channel pointer table and a planar
+// buffer sized for a fixed channel count and maximum block size.
+type ProcessContext struct {
+	handle      C.PedalboardProcessContext
+	processor   *Processor // Keep reference to prevent GC
+	channels    []*C.float
+	pinner      runtime.Pinner
+	numChannels int
+	maxSamples  int
+	// Data is the context's planar buffer as [channel][sample], viewing C
+	// memory. Fill it and call ProcessData for a zero-copy path.
+	Data [][]float32
+}
+
+// NewProcessContext creates a context for processing numChannels channels
+// in blocks of up to maxSamples samples.
+func (p *Processor) NewProcessContext(numChannels, maxSamples int) (*ProcessContext, error) {
+	handle := C.pedalboard_process_context_create(p.handle, C.int(numChannels), C.int(maxSamples))
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create process context")
+	}
+
+	planar := unsafe.Slice((*float32)(unsafe.Pointer(C.pedalboard_process_context_get_buffer(handle))), numChannels*maxSamples)
+	data := make([][]float32, numChannels)
+	for i := range data {
+		data[i] = planar[i*maxSamples : (i+1)*maxSamples : (i+1)*maxSamples]
+	}
+
+	ctx := &ProcessContext{
+		handle:      handle,
+		processor:   p,
+		channels:    unsafe.Slice(C.pedalboard_process_context_get_channels(handle), numChannels),
+		numChannels: numChannels,
+		maxSamples:  maxSamples,
+		Data:        data,
+	}
+	runtime.SetFinalizer(ctx, (*ProcessContext).Close)
+	return ctx, nil
+}
+
+// Process processes Go-owned planar audio in-place. The channel slices are
+// pinned for the duration of the call and written into the context's
+// pointer table, so no pointer array is allocated.
+func (c *ProcessContext) Process(buffer [][]float32, sampleRate float64) {
+	if len(buffer) != c.numChannels || len(buffer[0]) == 0 {
+		return
+	}
+	for i := 0; i < c.numChannels; i++ {
+		c.pinner.Pin(&buffer[i][0])
+		c.channels[i] = (*C.float)(unsafe.Pointer(&buffer[i][0]))
+	}
+	C.pedalboard_process_context_process(c.handle, C.int(len(buffer[0])), C.double(sampleRate))
+	c.pinner.Unpin()
+}
+
+// ProcessAutomated is Process with parameter changes applied at their sample
+// offsets. See Processor.ProcessAutomated.
+func (c *ProcessContext) ProcessAutomated(buffer [][]float32, sampleRate float64, events []ParameterEvent) {
+	if len(buffer) != c.numChannels || len(buffer[0]) == 0 {
+		return
+	}
+	for i := 0; i < c.numChannels; i++ {
+		c.pinner.Pin(&buffer[i][0])
+		c.channels[i] = (*C.float)(unsafe.Pointer(&buffer[i][0]))
+	}
+	cEvents, numEvents := parameterEvents(events)
+	C.pedalboard_process_context_process_automated(c.handle, C.int(len(buffer[0])), C.double(sampleRate), cEvents, numEvents)
+	c.pinner.Unpin()
+}
+
+// ProcessData processes the first numSamples samples of Data in-place.
+func (c *ProcessContext) ProcessData(numSamples int, sampleRate float64) {
+	C.pedalboard_process_context_process_buffer(c.handle, C.int(numSamples), C.double(sampleRate))
+}
+
+// ProcessInterleaved processes interleaved frames ([frame][channel]) in-place.
+func (c *ProcessContext) ProcessInterleaved(samples []float32, sampleRate float64) {
+	numFrames := len(samples) / c.numChannels
+	if numFrames == 0 {
+		return
+	}
+	C.pedalboard_process_context_process_interleaved(
+		c.handle,
+		(*C.float)(unsafe.Pointer(&samples[0])),
+		C.int(numFrames),
+		C.double(sampleRate),
+	)
+}
+
+// Close releases the context. It is safe to call more than once.
+func (c *ProcessContext) Close() {
+	if c.handle == nil {
+		return
+	}
+	C.pedalboard_process_context_free(c.handle)
+	c.handle = nil
+	c.channels = nil
+	c.Data = nil
+	runtime.SetFinalizer(c, nil)
+}
+
+// ParameterEvent changes a parameter at a sample offset within a process
+// call. Its layout matches PedalboardParameterEvent, so a slice of events
+// is passed to the bridge without copying.
+type ParameterEvent struct {
+	Offset int32 // Sample offset from the start of the buffer
+	Index  int32 // Parameter index, as for SetParameter
+	Value  float32
+}
+
+func parameterEvents(events []ParameterEvent) (*C.PedalboardParameterEvent, C.int) {
+	if len(events) == 0 {
+		return nil, 0
+	}
+	return (*C.PedalboardParameterEvent)(unsafe.Pointer(&events[0])), C.int(len(events))
+}
+
+// ProcessAutomated processes buffer in-place like Process, applying each
+// event exactly at its offset rather than at the next block boundary. A
+// whole automated render can be done in large blocks with one call per
+// block. Events must be sorted by Offset.
+func (p *Processor) ProcessAutomated(buffer [][]float32, sampleRate float64, events []ParameterEvent) {
+	numChannels := len(buffer)
+	if numChannels == 0 {
+		return
+	}
+
+	cPtrs := channelPointers(buffer)
+	if cPtrs == nil {
+		return
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+
+	cEvents, numEvents := parameterEvents(events)
+	C.pedalboard_processor_process_automated(p.handle, cPtrs, C.int(numChannels), C.int(len(buffer[0])), C.double(sampleRate), cEvents, numEvents)
+}
+
+// SetParameter sets a parameter value for the processor.
+// index: The 0-based index of the parameter.
+// value: The new value (typically normalized 0.0 to 1.0).
+func (p *Processor) SetParameter(index int, value float32) {
+	C.pedalboard_processor_set_parameter(p.handle, C.int(index), C.float(value))
+}
+
+// GetParameter returns the current value of a parameter.
+// index: The 0-based index of the parameter.
+// Returns the parameter value.
+func (p *Processor) GetParameter(index int) float32 {
+	return float32(C.pedalboard_processor_get_parameter(p.handle, C.int(index)))
+}
+
+// NumParameters returns the total number of parameters available in the processor.
+func (p *Processor) NumParameters() int {
+	return int(C.pedalboard_processor_get_num_parameters(p.handle))
+}
+
+// Latency returns the delay the processor adds, in samples.
+func (p *Processor) Latency() int {
+	return int(C.pedalboard_processor_get_latency_samples(p.handle))
+}
+
+// LoadImpulseResponse loads an audio file as the impulse response of a
+// "Convolution" processor. The IR is resampled to the processing rate if
+// needed, and processors loading the same file share its storage.
+func (p *Processor) LoadImpulseResponse(path string) error {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+	if C.pedalboard_convolution_load_impulse_response(p.handle, cPath) == 0 {
+		return fmt.Errorf("failed to load impulse response %s", path)
+	}
+	return nil
+}
+
+// SetImpulseResponse sets the impulse response of a "Convolution" processor
+// from planar samples at sampleRate. The samples are copied.
+func (p *Processor) SetImpulseResponse(ir [][]float32, sampleRate float64) error {
+	if len(ir) == 0 || len(ir[0]) == 0 {
+		return fmt.Errorf("impulse response is empty")
+	}
+	cPtrs := channelPointers(ir)
+	if cPtrs == nil {
+		return fmt.Errorf("failed to allocate channel pointers")
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+
+	if C.pedalboard_convolution_set_impulse_response(p.handle, cPtrs, C.int(len(ir)), C.int(len(ir[0])), C.double(sampleRate)) == 0 {
+		return fmt.Errorf("failed to set impulse response")
+	}
+	return nil
+}
+
+// SetConvolutionHeadSize sets the first partition size of a "Convolution"
+// processor, which is also its latency in samples. It is rounded up to a
+// power of two of at least 32; 0 uses the prepared block size, the lowest
+// latency available. Larger heads cost less CPU.
+func (p *Processor) SetConvolutionHeadSize(numSamples int) error {
+	if C.pedalboard_convolution_set_head_size(p.handle, C.int(numSamples)) == 0 {
+		return fmt.Errorf("failed to set convolution head size")
+	}
+	return nil
+}
+
+// ProcessorStats is the processing time recorded for a processor, wherever it
+// ran: directly, inside a chain or graph, or on an audio stream.
+type ProcessorStats struct {
+	Calls    int64
+	Total    time.Duration
+	Max      time.Duration
+	Bypassed int64 // Silent blocks skipped by auto-bypass, not included in Calls
+}
+
+// Mean returns the average time per process call.
+func (s ProcessorStats) Mean() time.Duration {
+	if s.Calls == 0 {
+		return 0
+	}
+	return s.Total / time.Duration(s.Calls)
+}
+
+// Stats returns the processor's timing counters. It is safe to call while
+// the processor is running on an audio stream.
+func (p *Processor) Stats() ProcessorStats {
+	var stats C.PedalboardProcessorStats
+	C.pedalboard_processor_get_stats(p.handle, &stats)
+	return ProcessorStats{
+		Calls:    int64(stats.calls),
+		Total:    time.Duration(stats.total_ns),
+		Max:      time.Duration(stats.max_ns),
+		Bypassed: int64(stats.bypassed),
+	}
+}
+
+// ResetStats clears the processor's timing counters.
+func (p *Processor) ResetStats() {
+	C.pedalboard_processor_reset_stats(p.handle)
+}
+
+// SetAnalyzer measures the processor's output after every block, wherever
+// it runs, so levels and loudness come for free with processing. nil
+// detaches. Detach before closing the analyzer; clones don't inherit it.
+func (p *Processor) SetAnalyzer(a *Analyzer) {
+	var handle C.PedalboardAnalyzer
+	if a != nil {
+		handle = a.handle
+	}
+	C.pedalboard_processor_set_analyzer(p.handle, handle)
+	p.analyzer = a
+	if chain, ok := p.owner.(*Chain); ok {
+		chain.analyzer = a
+	}
+}
+
+// SetTap copies the processor's output into tap after every block,
+// wherever it runs (for example as a node of a chain on a live stream).
+// nil detaches; detach before closing the tap.
+func (p *Processor) SetTap(tap *AudioTap) {
+	C.pedalboard_processor_set_tap(p.handle, tap.cHandle())
+	p.tap = tap
+	if chain, ok := p.owner.(*Chain); ok {
+		chain.tap = tap
+	}
+}
+
+// AudioTap is a lock-free ring of audio that the native audio thread fills
+// and Go drains. Filling never blocks or allocates: when the ring is full,
+// new audio is dropped and counted, so a slow reader can't cause xruns.
+// Read it from one goroutine at a time.
+type AudioTap struct {
+	handle C.PedalboardAudioTap
+}
+
+// NewAudioTap creates a tap holding up to capacity samples per channel.
+func NewAudioTap(numChannels, capacity int) (*AudioTap, error) {
+	handle := C.pedalboard_audio_tap_create(C.int(numChannels), C.int(capacity))
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create audio tap for %d channels of %d samples", numChannels, capacity)
+	}
+	tap := &AudioTap{handle: handle}
+	runtime.SetFinalizer(tap, func(obj *AudioTap) {
+		C.pedalboard_audio_tap_free(obj.handle)
+	})
+	return tap, nil
+}
+
+func (t *AudioTap) cHandle() C.PedalboardAudioTap {
+	if t == nil {
+		return nil
+	}
+	return t.handle
+}
+
+// Read moves up to len(buffer[0]) samples per channel into buffer and
+// returns how many were moved. Channels beyond the tap's are silent.
+func (t *AudioTap) Read(buffer [][]float32) int {
+	if len(buffer) == 0 || len(buffer[0]) == 0 {
+		return 0
+	}
+	cPtrs := channelPointers(buffer)
+	if cPtrs == nil {
+		return 0
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+	return int(C.pedalboard_audio_tap_read(t.handle, cPtrs, C.int(len(buffer)), C.int(len(buffer[0]))))
+}
+
+// Available returns the number of samples per channel ready to read.
+func (t *AudioTap) Available() int {
+	return int(C.pedalboard_audio_tap_get_num_available(t.handle))
+}
+
+// Dropped returns the number of samples per channel lost because the ring was full.
+func (t *AudioTap) Dropped() int64 {
+	return int64(C.pedalboard_audio_tap_get_num_dropped(t.handle))
+}
+
+// Close frees the tap. Detach it first.
+func (t *AudioTap) Close() {
+	if t.handle != nil {
+		runtime.SetFinalizer(t, nil)
+		C.pedalboard_audio_tap_free(t.handle)
+		t.handle = nil
+	}
+}
+
+// Analyzer accumulates level, loudness and spectrum measurements over
+// everything it is fed, in native code.
+type Analyzer struct {
+	handle C.PedalboardAnalyzer
+}
+
+// Analysis is an Analyzer's measurements so far. Levels are linear;
+// loudness values are -Inf until enough audio has been measured.
+type Analysis struct {
+	Samples        int64
+	Peak           float32
+	TruePeak       float32 // Peak of the signal oversampled 4x
+	RMS            float32
+	MomentaryLUFS  float32 // Last 400 ms
+	ShortTermLUFS  float32 // Last 3 s
+	IntegratedLUFS float32 // EBU R128 gated loudness of everything measured
+}
+
+// NewAnalyzer creates an analyzer for audio at sampleRate with up to
+// numChannels channels. A non-zero fftSize also averages the spectrum of the
+// channel mix in frames of that size, rounded up to a power of two.
+func NewAnalyzer(sampleRate float64, numChannels, fftSize int) (*Analyzer, error) {
+	handle := C.pedalboard_analyzer_create(C.double(sampleRate), C.int(numChannels), C.int(fftSize))
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create analyzer for %d channels at %g Hz", numChannels, sampleRate)
+	}
+	a := &Analyzer{handle: handle}
+	runtime.SetFinalizer(a, func(obj *Analyzer) {
+		C.pedalboard_analyzer_free(obj.handle)
+	})
+	return a, nil
+}
+
+// Process measures a buffer without changing it.
+func (a *Analyzer) Process(buffer [][]float32) {
+	if len(buffer) == 0 || len(buffer[0]) == 0 {
+		return
+	}
+	cPtrs := channelPointers(buffer)
+	if cPtrs == nil {
+		return
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+	C.pedalboard_analyzer_process(a.handle, cPtrs, C.int(len(buffer)), C.int(len(buffer[0])))
+}
+
+// Results returns the measurements so far. It is safe to call while the
+// analyzer is attached to a running processor.
+func (a *Analyzer) Results() Analysis {
+	var r C.PedalboardAnalysis
+	C.pedalboard_analyzer_get_results(a.handle, &r)
+	return Analysis{
+		Samples:        int64(r.num_samples),
+		Peak:           float32(r.peak),
+		TruePeak:       float32(r.true_peak),
+		RMS:            float32(r.rms),
+		MomentaryLUFS:  float32(r.momentary_lufs),
+		ShortTermLUFS:  float32(r.short_term_lufs),
+		IntegratedLUFS: float32(r.integrated_lufs),
+	}
+}
+
+// Spectrum returns the average power of each FFT bin in dB relative to a
+// full-scale sine, from 0 Hz to Nyquist. It is empty without an fftSize.
+func (a *Analyzer) Spectrum() []float32 {
+	numBins := int(C.pedalboard_analyzer_get_spectrum(a.handle, nil, 0))
+	if numBins == 0 {
+		return nil
+	}
+	bins := make([]float32, numBins)
+	C.pedalboard_analyzer_get_spectrum(a.handle, (*C.float)(unsafe.Pointer(&bins[0])), C.int(numBins))
+	return bins
+}
+
+// Reset clears every measurement. Like Results, it is safe to call while
+// the analyzer is attached to a running processor.
+func (a *Analyzer) Reset() {
+	C.pedalboard_analyzer_reset(a.handle)
+}
+
+// Close frees the analyzer. Detach it from any processor first.
+func (a *Analyzer) Close() {
+	if a.handle != nil {
+		runtime.SetFinalizer(a, nil)
+		C.pedalboard_analyzer_free(a.handle)
+		a.handle = nil
+	}
+}
+
+// NewResampledProcessor wraps p so it always runs at internalRate. Audio at
+// any other rate is converted on the way in and out, so p is never
+// re-prepared (and never loses its state) when rates are mixed. The
+// conversion adds latency, which graphs compensate for automatically.
+func NewResampledProcessor(p *Processor, internalRate float64) (*Processor, error) {
+	handle := C.pedalboard_create_resampled_processor(p.handle, C.double(internalRate))
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create resampled processor at %g Hz", internalRate)
+	}
+	wrapped := wrapProcessor(handle)
+	wrapped.owner = p
+	return wrapped, nil
+}
+
+// Prepare configures the processor for a sample rate, maximum block size and
+// channel count (0 keeps the current layout). Process splits longer buffers
+// into blocks of at most maxBlockSize, so effect state such as delay lines
+// survives buffers of any length. Preparing resets that state.
+func (p *Processor) Prepare(sampleRate float64, maxBlockSize, numChannels int) error {
+	if C.pedalboard_processor_prepare(p.handle, C.double(sampleRate), C.int(maxBlockSize), C.int(numChannels)) == 0 {
+		return fmt.Errorf("failed to prepare processor for %d channels at %g Hz", numChannels, sampleRate)
+	}
+	return nil
+}
+
+// Clone returns an independent copy of the processor with the same
+// parameters and state. Chain processors are copied with all their children.
+func (p *Processor) Clone() (*Processor, error) {
+	handle := C.pedalboard_processor_clone(p.handle)
+	if handle == nil {
+		return nil, fmt.Errorf("failed to clone processor")
+	}
+	return wrapProcessor(handle), nil
+}
+
+// ProcessorPool hands out prepared copies of a prototype processor, so
+// concurrent jobs don't pay for instantiation and preparation on the hot path.
+type ProcessorPool struct {
+	handle C.PedalboardProcessorPool
+}
+
+// NewProcessorPool snapshots the prototype and pre-creates initialSize
+// copies prepared for the given sample rate and maximum block size.
+func NewProcessorPool(prototype *Processor, initialSize int, sampleRate float64, maxBlockSize int) (*ProcessorPool, error) {
+	handle := C.pedalboard_processor_pool_create(prototype.handle, C.int(initialSize), C.double(sampleRate), C.int(maxBlockSize))
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create processor pool")
+	}
+	pool := &ProcessorPool{handle: handle}
+	runtime.SetFinalizer(pool, func(obj *ProcessorPool) {
+		C.pedalboard_processor_pool_free(obj.handle)
+	})
+	return pool, nil
+}
+
+// Acquire borrows a processor from the pool, creating a new copy if none
+// are idle. The processor belongs to the pool; return it with Release.
+func (pool *ProcessorPool) Acquire() (*Processor, error) {
+	handle := C.pedalboard_processor_pool_acquire(pool.handle)
+	if handle == nil {
+		return nil, fmt.Errorf("failed to acquire processor")
+	}
+	return &Processor{handle: handle, owner: pool}, nil
+}
+
+// Release returns a borrowed processor to the pool. Its parameters are
+// restored to the prototype's and any effect tails are cleared.
+func (pool *ProcessorPool) Release(p *Processor) {
+	C.pedalboard_processor_pool_release(pool.handle, p.handle)
+	p.handle = nil
+}
+
+// Available returns the number of idle processors in the pool.
+func (pool *ProcessorPool) Available() int {
+	return int(C.pedalboard_processor_pool_get_num_available(pool.handle))
+}
+
+// Close frees the pool and every processor it created.
+func (pool *ProcessorPool) Close() {
+	if pool.handle != nil {
+		runtime.SetFinalizer(pool, nil)
+		C.pedalboard_processor_pool_free(pool.handle)
+		pool.handle = nil
+	}
+}
+
+// Chain is an ordered list of processors that runs in a single native call.
+// Processing a chain is equivalent to calling Process on each processor in
+// turn, without crossing into C once per effect.
+type Chain struct {
+	handle     C.PedalboardChain
+	processors []*Processor // Keep references to prevent GC
+	analyzer   *Analyzer    // Set through AsProcessor().SetAnalyzer
+	tap        *AudioTap    // Set through AsProcessor().SetTap
+}
+
+// NewChain creates a chain containing the given processors, in order.
+func NewChain(processors ...*Processor) (*Chain, error) {
+	handle := C.pedalboard_chain_create()
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create chain")
+	}
+	c := &Chain{handle: handle}
+	runtime.SetFinalizer(c, func(obj *Chain) {
+		C.pedalboard_chain_free(obj.handle)
+	})
+
+	for _, p := range processors {
+		if err := c.Append(p); err != nil {
+			return nil, err
+		}
+	}
+	return c, nil
+}
+
+// Append adds a processor to the end of the chain.
+func (c *Chain) Append(p *Processor) error {
+	return c.Insert(len(c.processors), p)
+}
+
+// Insert adds a processor at the given position in the chain.
+// index: The 0-based position, between 0 and Len() inclusive.
+func (c *Chain) Insert(index int, p *Processor) error {
+	if p == nil || index < 0 || index > len(c.processors) {
+		return fmt.Errorf("invalid chain insert at index %d", index)
+	}
+	if C.pedalboard_chain_insert(c.handle, C.int(index), p.handle) == 0 {
+		return fmt.Errorf("failed to insert processor at index %d", index)
+	}
+	c.processors = append(c.processors, nil)
+	copy(c.processors[index+1:], c.processors[index:])
+	c.processors[index] = p
+	return nil
+}
+
+// Remove removes the processor at the given position from the chain.
+func (c *Chain) Remove(index int) error {
+	if index < 0 || index >= len(c.processors) {
+		return fmt.Errorf("invalid chain index %d", index)
+	}
+	if C.pedalboard_chain_remove(c.handle, C.int(index)) == 0 {
+		return fmt.Errorf("failed to remove processor at index %d", index)
+	}
+	c.processors = append(c.processors[:index], c.processors[index+1:]...)
+	return nil
+}
+
+// Len returns the number of processors in the chain.
+func (c *Chain) Len() int {
+	return int(C.pedalboard_chain_get_num_processors(c.handle))
+}
+
+// Process runs a block of audio through every processor in the chain.
+// buffer: The audio data to process (modified in-place).
+// sampleRate: The sample rate of the audio data.
+func (c *Chain) Process(buffer [][]float32, sampleRate float64) {
+	numChannels := len(buffer)
+	if numChannels == 0 {
+		return
+	}
+	numSamples := len(buffer[0])
+
+	cPtrs := channelPointers(buffer)
+	if cPtrs == nil {
+		return
+	}
+	defer C.free(unsafe.Pointer(cPtrs))
+
+	C.pedalboard_chain_process(
+		c.handle,
+		cPtrs,
+		C.int(numChannels),
+		C.int(numSamples),
+		C.double(sampleRate),
+	)
+}
+
+// ProcessCompact runs a CompactAudioBuffer through the chain in-place.
+func (c *Chain) ProcessCompact(buffer *CompactAudioBuffer) {
+	if buffer.buffer == nil {
+		return
+	}
+	buffer.buffer.sample_rate = C.double(buffer.SampleRate)
+	C.pedalboard_chain_process_compact(c.handle, buffer.buffer)
+	runtime.KeepAlive(buffer)
+}
+
+// ProcessNative runs a NativeAudioBuffer through the chain in-place.
+func (c *Chain) ProcessNative(buffer *NativeAudioBuffer) {
+	if buffer.buffer == nil {
+		return
+	}
+	C.pedalboard_chain_process(
+		c.handle,
+		buffer.buffer.data,
+		buffer.buffer.num_channels,
+		buffer.buffer.num_samples,
+		C.double(buffer.SampleRate),
+	)
+	runtime.KeepAlive(buffer)
+}
+
+// SetAutoBypass enables skipping each processor while its input is silent
+// and its tail (a reverb's decay, a delay's echoes) has died away. The
+// silent input passes through unchanged, and processing resumes as soon as
+// signal returns, so the output matches an unbypassed chain to within
+// -100 dBFS. Skipped blocks are counted in each processor's Stats.
+func (c *Chain) SetAutoBypass(enabled bool) {
+	var flag C.int
+	if enabled {
+		flag = 1
+	}
+	C.pedalboard_chain_set_auto_bypass(c.handle, flag)
+}
+
+// Prepare configures the chain and every processor in it. See Processor.Prepare.
+func (c *Chain) Prepare(sampleRate float64, maxBlockSize, numChannels int) error {
+	return c.AsProcessor().Prepare(sampleRate, maxBlockSize, numChannels)
+}
+
+// AsProcessor returns a Processor view of the chain, so it can be used
+// with NewAudioStream or nested inside another chain.
+func (c *Chain) AsProcessor() *Processor {
+	return &Processor{handle: C.pedalboard_chain_as_processor(c.handle), owner: c}
+}
+
+// RenderJob describes one file to render in a batch.
+type RenderJob struct {
+	Input  string
+	Output string
+}
+
+// RenderBatch renders every job's input file through the chain into its
+// output file, using numThreads native worker threads (0 uses one per CPU).
+// Each worker runs a private copy of the chain.
+// Returns per-job success flags, and an error if any job failed.
+func (c *Chain) RenderBatch(jobs []RenderJob, numThreads int) ([]bool, error) {
+	return c.RenderBatchCached(jobs, numThreads, nil)
+}
+
+// RenderBatchCached is RenderBatch with a render cache: a job whose input,
+// chain state, sample rate and output format match an earlier render copies
+// that result instead of processing. A nil cache renders every job.
+func (c *Chain) RenderBatchCached(jobs []RenderJob, numThreads int, cache *RenderCache) ([]bool, error) {
+	numJobs := len(jobs)
+	if numJobs == 0 {
+		return nil, nil
+	}
+
+	ptrSize := C.size_t(unsafe.Sizeof((*C.char)(nil)))
+	cInputs := (**C.char)(C.malloc(C.size_t(numJobs) * ptrSize))
+	cOutputs := (**C.char)(C.malloc(C.size_t(numJobs) * ptrSize))
+	cResults := (*C.int)(C.calloc(C.size_t(numJobs), C.size_t(unsafe.Sizeof(C.int(0)))))
+	defer C.free(unsafe.Pointer(cInputs))
+	defer C.free(unsafe.Pointer(cOutputs))
+	defer C.free(unsafe.Pointer(cResults))
+
+	inputs := unsafe.Slice(cInputs, numJobs)
+	outputs := unsafe.Slice(cOutputs, numJobs)
+	for i, job := range jobs {
+		inputs[i] = C.CString(job.Input)
+		outputs[i] = C.CString(job.Output)
+	}
+	defer func() {
+		for i := range jobs {
+			C.free(unsafe.Pointer(inputs[i]))
+			C.free(unsafe.Pointer(outputs[i]))
+		}
+	}()
+
+	var cCache C.PedalboardRenderCache
+	if cache != nil {
+		cCache = cache.handle
+	}
+	succeeded := int(C.pedalboard_render_batch_cached(c.handle, cCache, cInputs, cOutputs, C.int(numJobs), C.int(numThreads), cResults))
+	runtime.KeepAlive(cache)
+
+	results := make([]bool, numJobs)
+	for i, r := range unsafe.Slice(cResults, numJobs) {
+		results[i] = r != 0
+	}
+	if succeeded != numJobs {
+		return results, fmt.Errorf("%d of %d render jobs failed", numJobs-succeeded, numJobs)
+	}
+	return results, nil
+}
+
+// RenderCache stores rendered files for RenderBatchCached, keyed by a hash
+// of the input file, the chain's structure and every processor's state, the
+// sample rate and the output format. It is safe to share between batches.
+type RenderCache struct {
+	handle C.PedalboardRenderCache
+}
+
+// RenderCacheStats reports how often a RenderCache saved a render.
+type RenderCacheStats struct {
+	Hits        int64
+	Misses      int64
+	MemoryBytes int64
+	Entries     int // Files held in memory
+}
+
+// NewRenderCache creates a cache holding up to maxMemoryBytes of rendered
+// files in memory, evicting the least recently used. If directory is not
+// empty, every render is also kept there and reused across runs.
+func NewRenderCache(maxMemoryBytes int64, directory string) (*RenderCache, error) {
+	var cDirectory *C.char
+	if directory != "" {
+		cDirectory = C.CString(directory)
+		defer C.free(unsafe.Pointer(cDirectory))
+	}
+	handle := C.pedalboard_render_cache_create(C.int64_t(maxMemoryBytes), cDirectory)
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create render cache")
+	}
+	cache := &RenderCache{handle: handle}
+	runtime.SetFinalizer(cache, func(obj *RenderCache) {
+		C.pedalboard_render_cache_free(obj.handle)
+	})
+	return cache, nil
+}
+
+// Stats returns the cache's hit and miss counts and memory use.
+func (c *RenderCache) Stats() RenderCacheStats {
+	var stats C.PedalboardRenderCacheStats
+	C.pedalboard_render_cache_get_stats(c.handle, &stats)
+	return RenderCacheStats{
+		Hits:        int64(stats.hits),
+		Misses:      int64(stats.misses),
+		MemoryBytes: int64(stats.memory_bytes),
+		Entries:     int(stats.num_entries),
+	}
+}
+
+// Clear empties the memory cache. Files in the cache directory are kept.
+func (c *RenderCache) Clear() {
+	C.pedalboard_render_cache_clear(c.handle)
+}
+
+// Close frees the cache.
+func (c *RenderCache) Close() {
+	if c.handle != nil {
+		runtime.SetFinalizer(c, nil)
+		C.pedalboard_render_cache_free(c.handle)
+		c.handle = nil
+	}
+}
+
+// Graph node ids that every graph starts with.
+const (
+	GraphInput  = C.PEDALBOARD_GRAPH_INPUT_NODE
+	GraphOutput = C.PEDALBOARD_GRAPH_OUTPUT_NODE
+)
+
+// Graph routes audio from GraphInput to GraphOutput through processor, mix
+// and crossover nodes. Each node sums everything connected to it, and one
+// node may feed several others, so dry/wet splits and multiband chains need
+// no copying or mixing in Go. Parallel branches are aligned by latency, and
+// can run on several threads (see SetNumThreads).
+type Graph struct {
+	handle     C.PedalboardGraph
+	processors []*Processor // Keep references to prevent GC
+}
+
+// NewGraph creates a graph containing only its input and output nodes.
+func NewGraph() (*Graph, error) {
+	handle := C.pedalboard_graph_create()
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create graph")
+	}
+	g := &Graph{handle: handle}
+	runtime.SetFinalizer(g, func(obj *Graph) {
+		C.pedalboard_graph_free(obj.handle)
+	})
+	return g, nil
+}
+
+// AddProcessor adds a processor node and returns its id. A processor can
+// only be added to a graph once.
+func (g *Graph) AddProcessor(p *Processor) (int, error) {
+	id := int(C.pedalboard_graph_add_processor(g.handle, p.handle))
+	if id < 0 {
+		return -1, fmt.Errorf("failed to add processor to graph")
+	}
+	g.processors = append(g.processors, p)
+	return id, nil
+}
+
+// AddMix adds a node that sums its inputs and applies gain.
+func (g *Graph) AddMix(gain float32) (int, error) {
+	id := int(C.pedalboard_graph_add_mix(g.handle, C.float(gain)))
+	if id < 0 {
+		return -1, fmt.Errorf("failed to add mix node")
+	}
+	return id, nil
+}
+
+// AddCrossover adds a Linkwitz-Riley crossover at frequency Hz. Connect
+// from port 0 for the low band and port 1 for the high band.
+func (g *Graph) AddCrossover(frequency float32) (int, error) {
+	id := int(C.pedalboard_graph_add_crossover(g.handle, C.float(frequency)))
+	if id < 0 {
+		return -1, fmt.Errorf("failed to add crossover at %g Hz", frequency)
+	}
+	return id, nil
+}
+
+// SetMixGain changes the gain of a mix node.
+func (g *Graph) SetMixGain(node int, gain float32) error {
+	if C.pedalboard_graph_set_mix_gain(g.handle, C.int(node), C.float(gain)) == 0 {
+		return fmt.Errorf("node %d is not a mix node", node)
+	}
+	return nil
+}
+
+// Connect routes output port sourcePort of source into dest. Port 0 is the
+// only port except on crossovers.
+func (g *Graph) Connect(source, sourcePort, dest int) error {
+	if C.pedalboard_graph_connect(g.handle, C.int(source), C.int(sourcePort), C.int(dest)) == 0 {
+		return fmt.Errorf("failed to connect %d:%d to %d", source, sourcePort, dest)
+	}
+	return nil
+}
+
+// Disconnect removes a connection made with Connect.
+func (g *Graph) Disconnect(source, sourcePort, dest int) error {
+	if C.pedalboard_graph_disconnect(g.handle, C.int(source), C.int(sourcePort), C.int(dest)) == 0 {
+		return fmt.Errorf("no connection from %d:%d to %d", source, sourcePort, dest)
+	}
+	return nil
+}
+
+// SetNumThreads sets how many threads process independent branches. 1 (the
+// default) uses only the calling thread; 0 uses one per CPU. The extra
+// threads spin while the graph processes blocks regularly, so each keeps a
+// core busy, and a block waits for the slowest branch they run.
+func (g *Graph) SetNumThreads(numThreads int) {
+	C.pedalboard_graph_set_num_threads(g.handle, C.int(numThreads))
+}
+
+// Latency returns the graph's latency in samples, including compensation.
+func (g *Graph) Latency() int {
+	return int(C.pedalboard_graph_get_latency_samples(g.handle))
+}
+
+// Process runs the buffer through the graph in-place.
+func (g *Graph) Process(buffer [][]float32, sampleRate float64) {
+	g.AsProcessor().Process(buffer, sampleRate)
+}
+
+// AsProcessor returns a Processor view of the graph, so it can be used
+// with NewAudioStream or inside a chain.
+func (g *Graph) AsProcessor() *Processor {
+	return &Processor{handle: C.pedalboard_graph_as_processor(g.handle), owner: g}
+}
+
+// AudioStream represents a live audio stream processing audio from default input to output.
+type AudioStream struct {
+	handle    C.PedalboardAudioStream
+	processor *Processor // Keep reference to prevent GC
+	inputTap  *AudioTap
+	outputTap *AudioTap
+}
+
+// NewAudioStream creates a new audio stream using the specified processor.
+// It opens the default audio input and output devices.
+// processor: The processor to apply to the audio stream.
+// Returns the AudioStream instance or an error.
+func NewAudioStream(processor *Processor) (*AudioStream, error) {
+	handle := C.pedalboard_create_audio_stream(processor.handle)
+	if handle == nil {
+		return nil, fmt.Errorf("failed to create audio stream")
+	}
+	return &AudioStream{handle: handle, processor: processor}, nil
+}
+
+// StreamConfig selects the devices and settings for NewAudioStreamWithConfig.
+// Zero values use the device defaults; channel counts of 0 use 2.
+type StreamConfig struct {
+	InputDevice       string
+	OutputDevice      string
+	SampleRate        float64
+	BufferSize        int // In samples; small sizes such as 32 or 64 reduce latency
+	NumInputChannels  int
+	NumOutputChannels int
+}
+
+// NewAudioStreamWithConfig creates an audio stream on the configured devices.
+// The driver may round the sample rate or buffer size; use Info to see what
+// the device actually opened with.
+func NewAudioStreamWithConfig(processor *Processor, config StreamConfig) (*AudioStream, error) {
+	var cConfig C.PedalboardStreamConfig
+	if config.InputDevice != "" {
+		cConfig.input_device = C.CString(config.InputDevice)
+		defer C.free(unsafe.Pointer(cConfig.input_device))
+	}
+	if config.OutputDevice != "" {
+		cConfig.output_device = C.CString(config.OutputDevice)
+		defer C.free(unsafe.Pointer(cConfig.output_device))
+	}
+	cConfig.sample_rate = C.double(config.SampleRate)
+	cConfig.buffer_size = C.int(config.BufferSize)
+	cConfig.num_input_channels = C.int(config.NumInputChannels)
+	cConfig.num_output_channels = C.int(config.NumOutputChannels)
+
+	handle := C.pedalboard_create_audio_stream_with_config(processor.handle, &cConfig)
+	if handle == nil {
+		return nil, fmt.Errorf("failed to open audio devices (input %q, output %q)", config.InputDevice, config.OutputDevice)
+	}
+	return &AudioStream{handle: handle, processor: processor}, nil
+}
+
+// StreamInfo describes the settings an audio stream's device opened with.
+// Latencies are in samples.
+type StreamInfo struct {
+	SampleRate        float64
+	BufferSize        int
+	NumInputChannels  int
+	NumOutputChannels int
+	InputLatency      int
+	OutputLatency     int
+	ProcessorLatency  int
+}
+
+// RoundTripLatency returns the total input, buffer, processing and output latency.
+func (i StreamInfo) RoundTripLatency() time.Duration {
+	if i.SampleRate <= 0 {
+		return 0
+	}
+	samples := i.InputLatency + i.BufferSize + i.ProcessorLatency + i.OutputLatency
+	return time.Duration(float64(samples) * float64(time.Second) / i.SampleRate)
+}
+
+// Info returns the stream's actual device settings and latency.
+func (s *AudioStream) Info() StreamInfo {
+	var info C.PedalboardStreamInfo
+	C.pedalboard_audio_stream_get_info(s.handle, &info)
+	return StreamInfo{
+		SampleRate:        float64(info.sample_rate),
+		BufferSize:        int(info.buffer_size),
+		NumInputChannels:  int(info.num_input_channels),
+		NumOutputChannels: int(info.num_output_channels),
+		InputLatency:      int(info.input_latency_samples),
+		OutputLatency:     int(info.output_latency_samples),
+		ProcessorLatency:  int(info.processor_latency_samples),
+	}
+}
+
+// StreamStats describes how close a stream's callbacks come to their
+// deadline. Load is callback time divided by the buffer period, so a load
+// above 1.0 is an overrun. Percentiles are accurate to 0.05.
+type StreamStats struct {
+	Callbacks    int64
+	Overruns     int64 // Callbacks that took longer than the buffer period
+	XRuns        int64 // As reported by the driver, or -1 if unsupported
+	Total        time.Duration
+	Max          time.Duration
+	BufferPeriod time.Duration
+	MaxLoad      float64
+	P50Load      float64
+	P95Load      float64
+	P99Load      float64
+}
+
+// MeanLoad returns the average callback time as a fraction of the buffer period.
+func (s StreamStats) MeanLoad() float64 {
+	if s.Callbacks == 0 || s.BufferPeriod == 0 {
+		return 0
+	}
+	return float64(s.Total) / float64(s.Callbacks) / float64(s.BufferPeriod)
+}
+
+// Stats returns the stream's callback timing. It can be polled while the stream runs.
+// Per-processor times are available from each processor's Stats.
+func (s *AudioStream) Stats() StreamStats {
+	var stats C.PedalboardStreamStats
+	C.pedalboard_audio_stream_get_stats(s.handle, &stats)
+	return StreamStats{
+		Callbacks:    int64(stats.callbacks),
+		Overruns:     int64(stats.overruns),
+		XRuns:        int64(stats.xruns),
+		Total:        time.Duration(stats.total_callback_ns),
+		Max:          time.Duration(stats.max_callback_ns),
+		BufferPeriod: time.Duration(stats.last_period_ns),
+		MaxLoad:      float64(stats.max_load),
+		P50Load:      float64(stats.p50_load),
+		P95Load:      float64(stats.p95_load),
+		P99Load:      float64(stats.p99_load),
+	}
+}
+
+// ResetStats clears the stream's callback counters.
+func (s *AudioStream) ResetStats() {
+	C.pedalboard_audio_stream_reset_stats(s.handle)
+}
+
+// SetAutoBypass skips the stream's processor on silent input once its tail
+// has decayed. See Chain.SetAutoBypass.
+func (s *AudioStream) SetAutoBypass(enabled bool) {
+	var flag C.int
+	if enabled {
+		flag = 1
+	}
+	C.pedalboard_audio_stream_set_auto_bypass(s.handle, flag)
+}
+
+// SetInputTap copies the device input, before processing, into tap. nil
+// detaches; detach before closing the tap.
+func (s *AudioStream) SetInputTap(tap *AudioTap) {
+	C.pedalboard_audio_stream_set_input_tap(s.handle, tap.cHandle())
+	s.inputTap = tap
+}
+
+// SetOutputTap copies what the device plays into tap, for recording or
+// metering a live stream. nil detaches; detach before closing the tap.
+func (s *AudioStream) SetOutputTap(tap *AudioTap) {
+	C.pedalboard_audio_stream_set_output_tap(s.handle, tap.cHandle())
+	s.outputTap = tap
+}
+
+// Start starts the audio processing on the stream.
+func (s *AudioStream) Start() {
+	C.pedalboard_audio_stream_start(s.handle)
+}
+
+// Stop stops the audio processing on the stream.
+func (s *AudioStream) Stop() {
+	C.pedalboard_audio_stream_stop(s.handle)
+}
+
+// Close releases the audio stream resources.
+func (s *AudioStream) Close() {
+	C.pedalboard_audio_stream_free(s.handle)
+}
+
+// GetInputDevices returns the names of the available audio input devices.
+func GetInputDevices() ([]string, error) {
+	return deviceNames(true)
+}
+
+// GetOutputDevices returns the names of the available audio output devices.
+func GetOutputDevices() ([]string, error) {
+	return deviceNames(false)
+}
+
+func deviceNames(input bool) ([]string, error) {
+	isInput := C.int(0)
+	if input {
+		isInput = 1
+	}
+	var count C.int
+	cNames := C.pedalboard_get_audio_device_names(isInput, &count)
+	if cNames == nil {
+		return []string{}, nil
+	}
+	defer C.pedalboard_free_device_names(cNames, count)
+
+	names := make([]string, 0, int(count))
+	for _, name := range unsafe.Slice(cNames, int(count)) {
+		if name != nil {
+			names = append(names, C.GoString(name))
+		}
+	}
+	return names, nil
+}
+
+// NewAudioStreamWithDevices creates a new audio stream using the specified
+// processor and devices. Empty names use the default device.
+func NewAudioStreamWithDevices(processor *Processor, inputDevice, outputDevice string) (*AudioStream, error) {
+	return NewAudioStreamWithConfig(processor, StreamConfig{InputDevice: inputDevice, OutputDevice: outputDevice})
+}
@@ -11,21 +11,299 @@ extern "C" {
 // Handle types
 typedef void* PedalboardProcessor;
 
-// Global initialization
+// Global initialization. Safe to call from any thread, and every entry point
+// calls it itself, but the first call creates JUCE's message manager and
+// makes its thread the message thread: call it from the main thread before
+// using plugins or audio devices. Audio formats and plugin formats are still
+// registered on first use.
 void pedalboard_init();
 
 // Processor management
 PedalboardProcessor pedalboard_create_internal_processor(const char* name);
+
+// Names accepted by pedalboard_create_internal_processor. The returned
+// strings are static; NULL if index is out of range.
+int pedalboard_get_num_internal_processors();
+const char* pedalboard_get_internal_processor_name(int index);
+
+// Fused chains run a fixed sequence of internal processors as one processor,
+// calling each stage directly and passing the block through all of them a
+// chunk at a time so it stays in cache. Only compiled-in presets exist;
+// pedalboard_create_fused_chain returns NULL for any other sequence, which
+// can use a regular chain instead. Parameters are indexed across all stages
+// in order: stage 0's, then stage 1's, and so on.
+PedalboardProcessor pedalboard_create_fused_chain(const char** names, int num_names);
+int pedalboard_get_num_fused_chain_presets();
+// Writes up to max_names static stage names and returns the preset's stage count.
+int pedalboard_get_fused_chain_preset(int index, const char** names, int max_names);
+
+// Impulse responses for a "Convolution" processor. An IR at another sample
+// rate is resampled to the processing rate. Processors using the same IR
+// share its storage and spectra. Convolution adds a latency of the head size:
+// the prepared block size rounded up to a power of two (at least 32), or
+// the size set with pedalboard_convolution_set_head_size (0 restores the
+// default). Each returns 1 on success, 0 if the processor is not a
+// convolution processor or the IR is invalid or unreadable.
+int pedalboard_convolution_load_impulse_response(PedalboardProcessor processor, const char* path);
+int pedalboard_convolution_set_impulse_response(PedalboardProcessor processor, const float* const* data, int num_channels, int num_samples, double sample_rate);
+int pedalboard_convolution_set_head_size(PedalboardProcessor processor, int num_samples);
+
 PedalboardProcessor pedalboard_load_plugin(const char* path);
 void pedalboard_processor_free(PedalboardProcessor processor);
 void pedalboard_processor_set_parameter(PedalboardProcessor processor, int index, float value);
 float pedalboard_processor_get_parameter(PedalboardProcessor processor, int index);
 int pedalboard_processor_get_num_parameters(PedalboardProcessor processor);
+// Latency the processor reports, in samples. Internal processors update it
+// as soon as a parameter that changes it is set.
+int pedalboard_processor_get_latency_samples(PedalboardProcessor processor);
+
+// Creates an independent copy of a processor (or chain) with the same
+// parameters and state, prepared like the original. Free it with
+// pedalboard_processor_free. Returns NULL if the processor can't be copied.
+PedalboardProcessor pedalboard_processor_clone(PedalboardProcessor processor);
+
+// Processor Instrumentation
+// Every processor handle counts its process calls and time, wherever it
+// runs: directly, inside a chain or graph, or on an audio stream.
+typedef struct {
+    int64_t calls;
+    int64_t total_ns;
+    int64_t max_ns;
+    int64_t bypassed; // Silent blocks skipped by auto-bypass (not counted in calls)
+} PedalboardProcessorStats;
+
+void pedalboard_processor_get_stats(PedalboardProcessor processor, PedalboardProcessorStats* stats);
+void pedalboard_processor_reset_stats(PedalboardProcessor processor);
+
+// Analysis
+// Accumulates sample peak, 4x oversampled true peak, RMS, EBU R128
+// loudness and, if fft_size is not 0, an average spectrum of the channel
+// mix (fft_size is rounded up to a power of two). Feed it buffers directly,
+// or attach it to a processor to measure its output as a side effect of
+// processing. Results can be read, and the analyzer reset, from any thread
+// while it runs; processing never waits for either. Levels cover the
+// channels passed to each call.
+typedef void* PedalboardAnalyzer;
+
+typedef struct {
+    int64_t num_samples;
+    float peak;            // Linear, over all channels
+    float true_peak;       // Linear
+    float rms;             // Linear, over the channels passed
+    float momentary_lufs;  // Last 400 ms; -INFINITY until measured
+    float short_term_lufs; // Last 3 s
+    float integrated_lufs; // Everything since the last reset, gated
+} PedalboardAnalysis;
+
+PedalboardAnalyzer pedalboard_analyzer_create(double sample_rate, int num_channels, int fft_size);
+void pedalboard_analyzer_free(PedalboardAnalyzer analyzer);
+void pedalboard_analyzer_reset(PedalboardAnalyzer analyzer);
+// Channels beyond the analyzer's channel count are ignored.
+void pedalboard_analyzer_process(PedalboardAnalyzer analyzer, const float* const* samples, int num_channels, int num_samples);
+void pedalboard_analyzer_get_results(PedalboardAnalyzer analyzer, PedalboardAnalysis* results);
+// Writes up to max_bins average bin powers in dB relative to a full-scale
+// sine (decibels may be NULL) and returns the number of bins.
+int pedalboard_analyzer_get_spectrum(PedalboardAnalyzer analyzer, float* decibels, int max_bins);
+
+// Measures the processor's output after every block, wherever it runs. NULL
+// detaches. The analyzer is not owned and must be detached before it is
+// freed (detaching waits for a block in progress); clones don't inherit it.
+void pedalboard_processor_set_analyzer(PedalboardProcessor processor, PedalboardAnalyzer analyzer);
+
+// Audio Taps
+// A lock-free single-producer, single-consumer ring holding up to capacity
+// samples per channel. Attached to a processor (such as a chain node) or a
+// stream, the audio thread copies audio into it without locking or
+// allocating; whatever doesn't fit is dropped and counted instead. One
+// consumer thread drains it with pedalboard_audio_tap_read. Attach each tap
+// to one point at a time, and detach it (setting NULL waits for a block in
+// progress) before freeing it.
+typedef void* PedalboardAudioTap;
+
+PedalboardAudioTap pedalboard_audio_tap_create(int num_channels, int capacity);
+void pedalboard_audio_tap_free(PedalboardAudioTap tap);
+// Moves up to max_samples per channel into samples and returns how many were
+// moved. Channels beyond the tap's are filled with silence.
+int pedalboard_audio_tap_read(PedalboardAudioTap tap, float** samples, int num_channels, int max_samples);
+int pedalboard_audio_tap_get_num_available(PedalboardAudioTap tap);
+// Samples per channel lost because the ring was full.
+int64_t pedalboard_audio_tap_get_num_dropped(PedalboardAudioTap tap);
+
+// Copies the processor's output after every block, wherever it runs.
+void pedalboard_processor_set_tap(PedalboardProcessor processor, PedalboardAudioTap tap);
+
+// Wraps a processor so it always runs at internal_rate, converting to and
+// from whatever rate the wrapper is called at with a windowed-sinc
+// resampler. The inner processor stays prepared across calls at different
+// rates. The wrapper reports the conversion delay as latency and does not
+// own the inner processor; free it with pedalboard_processor_free.
+PedalboardProcessor pedalboard_create_resampled_processor(PedalboardProcessor processor, double internal_rate);
+
+// Processor Pool
+// A pool hands out prepared clones of a prototype to concurrent jobs.
+typedef void* PedalboardProcessorPool;
+
+// Snapshots the prototype and pre-creates initial_size prepared clones.
+PedalboardProcessorPool pedalboard_processor_pool_create(PedalboardProcessor prototype, int initial_size, double sample_rate, int max_block_size);
+
+// Borrows an idle processor, creating another clone if none are idle.
+// The returned processor is owned by the pool.
+PedalboardProcessor pedalboard_processor_pool_acquire(PedalboardProcessorPool pool);
+
+// Returns a borrowed processor; its state is restored to the prototype's and reset.
+void pedalboard_processor_pool_release(PedalboardProcessorPool pool, PedalboardProcessor processor);
+int pedalboard_processor_pool_get_num_available(PedalboardProcessorPool pool);
+
+// Frees the pool and every processor it created.
+void pedalboard_processor_pool_free(PedalboardProcessorPool pool);
+
+// Plugin Scan Cache
+// pedalboard_load_plugin only scans a plugin file the first time it is seen,
+// or after it has been modified. The cache lives in memory and, once a cache
+// file is set, is also persisted there.
+// Loads the cache file if it exists. Returns 1 on success, 0 if it is unreadable.
+int pedalboard_set_plugin_cache_file(const char* path);
+
+// Scans a directory recursively and adds every plugin found to the cache.
+// Returns the number of plugin types cached for that directory.
+int pedalboard_scan_plugins(const char* directory);
 
 // Audio processing
 // samples is a pointer to an array of float pointers (one per channel)
+// Calls longer than the prepared maximum block size are split internally, so
+// whole-file buffers can be passed in one call. A processor that was never
+// prepared is prepared on its first call, using that call's size as the maximum.
 void pedalboard_processor_process(PedalboardProcessor processor, float** samples, int num_channels, int num_samples, double sample_rate);
 
+// A parameter change at a sample offset within a process call.
+typedef struct {
+    int sample_offset;
+    int param_index;
+    float value;
+} PedalboardParameterEvent;
+
+// Like pedalboard_processor_process, but applies each event as if
+// pedalboard_processor_set_parameter were called exactly at its offset. The
+// call is split into sub-blocks at the offsets. Events must be in
+// ascending offset order; offsets before an earlier event's are moved up to it.
+void pedalboard_processor_process_automated(PedalboardProcessor processor, float** samples, int num_channels, int num_samples, double sample_rate,
+                                            const PedalboardParameterEvent* events, int num_events);
+
+// Prepares a processor (or chain) for the given rate, maximum block size and
+// channel count (0 keeps the current layout). This resets effect state, so
+// call it before processing rather than per block. Returns 1 on success, 0 if
+// the arguments are invalid or the processor rejected the channel layout (it
+// is still prepared for the rate and block size).
+int pedalboard_processor_prepare(PedalboardProcessor processor, double sample_rate, int max_block_size, int num_channels);
+
+// Processor Chain
+// A chain runs an ordered list of processors in-place in a single call.
+// The chain does not own its processors; they must outlive the chain.
+typedef void* PedalboardChain;
+
+PedalboardChain pedalboard_chain_create();
+void pedalboard_chain_free(PedalboardChain chain);
+
+// Returns 1 on success, 0 if the processor or index is invalid. Edits are
+// safe while the chain is processing on another thread, which never waits
+// for them; once remove returns, the removed processor is no longer in use.
+int pedalboard_chain_append(PedalboardChain chain, PedalboardProcessor processor);
+int pedalboard_chain_insert(PedalboardChain chain, int index, PedalboardProcessor processor);
+int pedalboard_chain_remove(PedalboardChain chain, int index);
+int pedalboard_chain_get_num_processors(PedalboardChain chain);
+
+// Auto-bypass skips each processor while its input is silent (peak below
+// -100 dBFS) and its reported tail has decayed, leaving the silence in
+// place, and runs it again as soon as signal returns. Processors that accept
+// MIDI or report an infinite tail are never skipped. Off by default.
+void pedalboard_chain_set_auto_bypass(PedalboardChain chain, int enabled);
+
+void pedalboard_chain_process(PedalboardChain chain, float** samples, int num_channels, int num_samples, double sample_rate);
+
+// Returns a processor handle for the chain so it can be used anywhere a
+// processor is accepted (audio streams, other chains). The returned handle
+// is owned by the chain and must not be freed with pedalboard_processor_free.
+PedalboardProcessor pedalboard_chain_as_processor(PedalboardChain chain);
+
+// Processor Graph
+// A graph routes audio between a fixed input and output node through
+// processor, mix and crossover nodes. Every node sums its incoming
+// connections, and one output may feed several connections (a split).
+// Nodes at the same depth run in parallel on the graph's threads, and
+// shorter paths are delayed to match the latency of the longest one.
+// Like a chain, the graph does not own its processors.
+typedef void* PedalboardGraph;
+
+enum {
+    PEDALBOARD_GRAPH_INPUT_NODE = 0,
+    PEDALBOARD_GRAPH_OUTPUT_NODE = 1
+};
+
+PedalboardGraph pedalboard_graph_create();
+void pedalboard_graph_free(PedalboardGraph graph);
+
+// The add functions return the new node's id, or -1 on failure.
+// A processor may only appear once in a graph.
+int pedalboard_graph_add_processor(PedalboardGraph graph, PedalboardProcessor processor);
+int pedalboard_graph_add_mix(PedalboardGraph graph, float gain);
+
+// Linkwitz-Riley split: output port 0 is the low band, port 1 the high band.
+int pedalboard_graph_add_crossover(PedalboardGraph graph, float frequency);
+
+// Returns 1 on success, 0 if node is not a mix node.
+int pedalboard_graph_set_mix_gain(PedalboardGraph graph, int node, float gain);
+
+// Connects output port source_port of source to the input of dest.
+// Returns 1 on success, 0 if a node or port is invalid or it would form a cycle.
+int pedalboard_graph_connect(PedalboardGraph graph, int source, int source_port, int dest);
+int pedalboard_graph_disconnect(PedalboardGraph graph, int source, int source_port, int dest);
+
+// 1 (the default) processes on the calling thread; 0 uses one thread per CPU.
+// The calling thread never blocks on the others, but it does wait for any
+// branch they have started, and they spin while the graph is processing
+// blocks regularly, so each one keeps a core busy.
+void pedalboard_graph_set_num_threads(PedalboardGraph graph, int num_threads);
+
+// Latency of the longest path, in samples. Follows processor latency changes
+// as soon as they are reported.
+int pedalboard_graph_get_latency_samples(PedalboardGraph graph);
+
+void pedalboard_graph_process(PedalboardGraph graph, float** samples, int num_channels, int num_samples, double sample_rate);
+
+// Returns a processor handle owned by the graph, as with pedalboard_chain_as_processor.
+PedalboardProcessor pedalboard_graph_as_processor(PedalboardGraph graph);
+
+// Process Context
+// A context is created once per processor and channel count. It keeps a
+// persistent channel pointer table and a planar buffer, so steady-state
+// processing performs no heap allocation.
+typedef void* PedalboardProcessContext;
+
+// max_samples bounds the planar buffer and interleaved chunk size.
+PedalboardProcessContext pedalboard_process_context_create(PedalboardProcessor processor, int num_channels, int max_samples);
+void pedalboard_process_context_free(PedalboardProcessContext context);
+
+// Returns the context's table of num_channels channel pointers. Callers may
+// point the entries at their own memory before calling _process.
+float** pedalboard_process_context_get_channels(PedalboardProcessContext context);
+
+// Returns the context's planar storage: channel i starts at i * max_samples.
+float* pedalboard_process_context_get_buffer(PedalboardProcessContext context);
+
+// Processes the memory the channel table points at.
+void pedalboard_process_context_process(PedalboardProcessContext context, int num_samples, double sample_rate);
+
+// Processes the memory the channel table points at, applying events as
+// pedalboard_processor_process_automated does.
+void pedalboard_process_context_process_automated(PedalboardProcessContext context, int num_samples, double sample_rate,
+                                                  const PedalboardParameterEvent* events, int num_events);
+
+// Processes the context's own planar storage (up to max_samples).
+void pedalboard_process_context_process_buffer(PedalboardProcessContext context, int num_samples, double sample_rate);
+
+// Processes interleaved frames in-place, in chunks of max_samples.
+void pedalboard_process_context_process_interleaved(PedalboardProcessContext context, float* samples, int num_frames, double sample_rate);
+
 // Audio File IO
 typedef struct {
     float** data;
@@ -34,17 +312,227 @@ typedef struct {
     double sample_rate;
 } PedalboardAudioBuffer;
 
+// Buffers allocated by the library hold all channels in one contiguous block:
+// data[i] == data[0] + i * num_samples. Free them with pedalboard_audio_buffer_free.
+// Returns a zero-filled buffer, or NULL if allocation failed.
+PedalboardAudioBuffer* pedalboard_audio_buffer_create(int num_channels, int num_samples, double sample_rate);
+
+// Options for writing audio files. Zeroed options write 16-bit audio at
+// the format's first quality setting, synchronously.
+typedef struct {
+    // 16, 24 or 32; WAV writes 32 as float. Must be supported by the format.
+    int bits_per_sample;
+    // Index into the format's quality options, e.g. the FLAC compression
+    // level (0-8) or the Ogg Vorbis bitrate step.
+    int quality;
+    // Non-zero encodes and writes on a shared background thread, so writes
+    // only copy into a FIFO. Writers only; ignored when saving a buffer.
+    int threaded;
+    // FIFO length per channel for threaded writers; 0 uses 65536.
+    int buffer_samples;
+} PedalboardAudioWriterOptions;
+
 PedalboardAudioBuffer* pedalboard_load_audio_file(const char* path);
 void pedalboard_save_audio_file(const char* path, PedalboardAudioBuffer* buffer);
+
+// Returns 1 on success, 0 if the file, format or options are invalid.
+int pedalboard_save_audio_file_with_options(const char* path, PedalboardAudioBuffer* buffer, const PedalboardAudioWriterOptions* options);
 void pedalboard_audio_buffer_free(PedalboardAudioBuffer* buffer);
 
+// Compact Buffers
+// Planar 16-bit audio at half the memory of PedalboardAudioBuffer: channel i
+// starts i * num_samples samples into data. Processing converts one block
+// at a time to float and back in place, so nothing larger than a block is
+// ever held as float. int16 samples are scaled by 1/32768 and clipped when
+// encoded; float16 (IEEE half) keeps levels above 0 dBFS.
+enum {
+    PEDALBOARD_SAMPLE_INT16 = 1,
+    PEDALBOARD_SAMPLE_FLOAT16 = 2
+};
+
+typedef struct {
+    void* data;
+    int format; // PEDALBOARD_SAMPLE_INT16 or PEDALBOARD_SAMPLE_FLOAT16
+    int num_channels;
+    int num_samples;
+    double sample_rate;
+} PedalboardCompactAudioBuffer;
+
+// Returns a zeroed buffer, or NULL if the format is unknown or allocation failed.
+PedalboardCompactAudioBuffer* pedalboard_compact_buffer_create(int format, int num_channels, int num_samples, double sample_rate);
+PedalboardCompactAudioBuffer* pedalboard_load_audio_file_compact(const char* path, int format);
+void pedalboard_compact_buffer_free(PedalboardCompactAudioBuffer* buffer);
+
+// Convert samples [start, start + num_samples) of the first num_channels
+// channels to or from float. Return 1 on success, 0 if out of range.
+int pedalboard_compact_buffer_read(const PedalboardCompactAudioBuffer* buffer, float** samples, int num_channels, int start, int num_samples);
+int pedalboard_compact_buffer_write(PedalboardCompactAudioBuffer* buffer, const float* const* samples, int num_channels, int start, int num_samples);
+
+// Processes the whole buffer in place at its sample rate.
+void pedalboard_processor_process_compact(PedalboardProcessor processor, PedalboardCompactAudioBuffer* buffer);
+void pedalboard_chain_process_compact(PedalboardChain chain, PedalboardCompactAudioBuffer* buffer);
+
+// Streaming Audio File IO
+// Readers and writers move audio in caller-sized chunks, so memory use
+// stays flat regardless of file length.
+typedef void* PedalboardAudioReader;
+typedef void* PedalboardAudioWriter;
+
+typedef struct {
+    int num_channels;
+    int64_t num_samples;
+    double sample_rate;
+    int bits_per_sample;
+} PedalboardAudioFileInfo;
+
+PedalboardAudioReader pedalboard_audio_reader_open(const char* path);
+
+// Opens WAV and AIFF files through a memory mapping instead of file reads.
+// Seeking is free, only the windows that are read are paged in, and several
+// processes reading the same file share its page cache. Samples are
+// converted to float as they are read. Other formats fall back to
+// pedalboard_audio_reader_open.
+PedalboardAudioReader pedalboard_audio_reader_open_mapped(const char* path);
+
+// Opens a file and converts it to sample_rate as it is read. get_info reports
+// the converted rate and length, and positions are in converted samples.
+PedalboardAudioReader pedalboard_audio_reader_open_resampled(const char* path, double sample_rate);
+
+// Returns 1 if the reader was opened through a memory mapping.
+int pedalboard_audio_reader_is_mapped(PedalboardAudioReader reader);
+void pedalboard_audio_reader_get_info(PedalboardAudioReader reader, PedalboardAudioFileInfo* info);
+
+// Reads up to num_samples from the current position into samples and
+// advances the position. Returns the number of samples read (0 at the end).
+int pedalboard_audio_reader_read(PedalboardAudioReader reader, float** samples, int num_channels, int num_samples);
+
+// Returns 1 on success, 0 if position is outside the file.
+int pedalboard_audio_reader_seek(PedalboardAudioReader reader, int64_t position);
+int64_t pedalboard_audio_reader_get_position(PedalboardAudioReader reader);
+void pedalboard_audio_reader_close(PedalboardAudioReader reader);
+
+// Format is determined by the file extension. bits_per_sample of 0 uses 16.
+// Audio goes to a temporary file beside path, which replaces any existing
+// file only when the writer is closed, so a failed open leaves it intact.
+PedalboardAudioWriter pedalboard_audio_writer_open(const char* path, double sample_rate, int num_channels, int bits_per_sample);
+
+PedalboardAudioWriter pedalboard_audio_writer_open_with_options(const char* path, double sample_rate, int num_channels, const PedalboardAudioWriterOptions* options);
+
+// Appends num_samples to the file. Returns 1 on success, 0 on failure.
+// Threaded writers only block if the background thread falls a full FIFO behind.
+int pedalboard_audio_writer_write(PedalboardAudioWriter writer, float** samples, int num_channels, int num_samples);
+
+// Flushes and closes the file, then moves it over path. For threaded writers
+// this waits for queued audio. Frees the writer either way; returns 1 on
+// success, 0 if the file couldn't be moved into place (it is deleted).
+int pedalboard_audio_writer_close(PedalboardAudioWriter writer);
+
+// Batch Rendering
+// Renders inputs[i] through the chain into outputs[i] for every job, on
+// num_threads worker threads (0 uses one per CPU). Each worker processes a
+// private copy of the chain, and every file starts from a clean state.
+// Each worker also decodes ahead of and encodes behind its processing on two
+// threads of its own, so even a single long file uses three cores.
+// results, if not NULL, receives 1 or 0 per job; every job is 0 if the
+// batch can't start, such as when the chain can't be copied for the
+// workers (see pedalboard_processor_clone). Returns the number of jobs
+// that succeeded.
+int pedalboard_render_batch(PedalboardChain chain, const char** inputs, const char** outputs, int num_jobs, int num_threads, int* results);
+
+// Render Cache
+// Stores rendered output files keyed by a hash of the input file, the
+// chain's structure and every processor's parameters and state, the sample
+// rate and the output format, so repeating an identical render copies the
+// stored file. Up to max_memory_bytes of files are kept in memory (least
+// recently used are evicted first); directory, if not NULL or empty, also
+// keeps every render on disk across runs. Chains holding processors that
+// can't be copied (see pedalboard_processor_clone) are never cached.
+typedef void* PedalboardRenderCache;
+
+typedef struct {
+    int64_t hits;
+    int64_t misses;
+    int64_t memory_bytes;
+    int num_entries; // Files held in memory
+} PedalboardRenderCacheStats;
+
+PedalboardRenderCache pedalboard_render_cache_create(int64_t max_memory_bytes, const char* directory);
+void pedalboard_render_cache_free(PedalboardRenderCache cache);
+// Empties the memory cache; files in the directory are kept.
+void pedalboard_render_cache_clear(PedalboardRenderCache cache);
+void pedalboard_render_cache_get_stats(PedalboardRenderCache cache, PedalboardRenderCacheStats* stats);
+
+// pedalboard_render_batch, checking cache (if not NULL) before each job and
+// storing every render it completes. The cache may be shared by concurrent batches.
+int pedalboard_render_batch_cached(PedalboardChain chain, PedalboardRenderCache cache, const char** inputs, const char** outputs,
+                                   int num_jobs, int num_threads, int* results);
+
 // Audio Stream (Live IO)
 typedef void* PedalboardAudioStream;
 
+// Zero or NULL fields use the device defaults; channel counts of 0 use 2.
+typedef struct {
+    const char* input_device;
+    const char* output_device;
+    double sample_rate;
+    int buffer_size;
+    int num_input_channels;
+    int num_output_channels;
+} PedalboardStreamConfig;
+
+// What the device actually opened with, which may differ from the request.
+typedef struct {
+    double sample_rate;
+    int buffer_size;
+    int num_input_channels;
+    int num_output_channels;
+    int input_latency_samples;
+    int output_latency_samples;
+    int processor_latency_samples;
+} PedalboardStreamInfo;
+
 // Creates an audio stream that processes audio from the default input device
 // through the given processor and sends it to the default output device.
+// Returns NULL if the devices could not be opened.
 PedalboardAudioStream pedalboard_create_audio_stream(PedalboardProcessor processor);
 
+// As above, opening the devices, rate, buffer size and channels in config.
+PedalboardAudioStream pedalboard_create_audio_stream_with_config(PedalboardProcessor processor, const PedalboardStreamConfig* config);
+
+void pedalboard_audio_stream_get_info(PedalboardAudioStream stream, PedalboardStreamInfo* info);
+
+// Callback timing, measured against the buffer period (load 1.0 means a
+// callback used its whole deadline). Counters are lock-free and can be
+// polled while the stream runs. xruns is as reported by the driver, or -1.
+typedef struct {
+    int64_t callbacks;
+    int64_t overruns;
+    int64_t xruns;
+    int64_t total_callback_ns;
+    int64_t max_callback_ns;
+    int64_t last_period_ns;
+    double max_load;
+    double p50_load;
+    double p95_load;
+    double p99_load;
+} PedalboardStreamStats;
+
+void pedalboard_audio_stream_get_stats(PedalboardAudioStream stream, PedalboardStreamStats* stats);
+void pedalboard_audio_stream_reset_stats(PedalboardAudioStream stream);
+
+// Skips the stream's processor on silent input once its tail has decayed,
+// as pedalboard_chain_set_auto_bypass does per processor. Off by default.
+void pedalboard_audio_stream_set_auto_bypass(PedalboardAudioStream stream, int enabled);
+
+// Taps the device input before processing, or the output the device plays.
+void pedalboard_audio_stream_set_input_tap(PedalboardAudioStream stream, PedalboardAudioTap tap);
+void pedalboard_audio_stream_set_output_tap(PedalboardAudioStream stream, PedalboardAudioTap tap);
+
+// Returns the names of the available input (is_input != 0) or output devices
+// across all driver types. Free the result with pedalboard_free_device_names.
+char** pedalboard_get_audio_device_names(int is_input, int* num_devices);
+void pedalboard_free_device_names(char** names, int num_devices);
+
 // Starts the audio stream.
 void pedalboard_audio_stream_start(PedalboardAudioStream stream);
 
@@ -0,0 +1,119 @@
+package pedalboard
+
+import (
+	"fmt"
+	"path/filepath"
+	"testing"
+)
+
+// Block sizes and channel counts covered by BenchmarkProcessors. Use
+// -bench 'Processors/Reverb' or similar to narrow a run.
+var (
+	benchBlockSizes    = []int{32, 64, 256, 1024, 8192}
+	benchChannelCounts = []int{1, 2}
+	benchSampleRates   = []float64{44100, 96000}
+)
+
+func benchSignal(numChannels, numSamples int) [][]float32 {
+	buffer := make([][]float32, numChannels)
+	seed := uint32(12345)
+	for c := range buffer {
+		buffer[c] = make([]float32, numSamples)
+		for i := range buffer[c] {
+			seed = seed*1664525 + 1013904223
+			buffer[c][i] = (float32(seed>>8)/16777216.0 - 0.5) * 0.5
+		}
+	}
+	return buffer
+}
+
+// BenchmarkProcessors measures every internal processor through a
+// ProcessContext, which is the allocation-free path. Throughput is reported
+// in bytes of float32 audio per second.
+func BenchmarkProcessors(b *testing.B) {
+	for _, name := range InternalProcessorNames() {
+		for _, sampleRate := range benchSampleRates {
+			for _, numChannels := range benchChannelCounts {
+				for _, blockSize := range benchBlockSizes {
+					b.Run(fmt.Sprintf("%s/rate=%g/ch=%d/block=%d", name, sampleRate, numChannels, blockSize), func(b *testing.B) {
+						p, err := NewInternalProcessor(name)
+						if err != nil {
+							b.Fatal(err)
+						}
+						if err := p.Prepare(sampleRate, blockSize, numChannels); err != nil {
+							b.Fatal(err)
+						}
+						ctx, err := p.NewProcessContext(numChannels, blockSize)
+						if err != nil {
+							b.Fatal(err)
+						}
+						defer ctx.Close()
+
+						buffer := benchSignal(numChannels, blockSize)
+						b.SetBytes(int64(numChannels * blockSize * 4))
+						b.ResetTimer()
+						for i := 0; i < b.N; i++ {
+							ctx.Process(buffer, sampleRate)
+						}
+					})
+				}
+			}
+		}
+	}
+}
+
+// BenchmarkCgoCrossing isolates the fixed cost of a call into the bridge:
+// a trivial getter, and processing a single sample.
+func BenchmarkCgoCrossing(b *testing.B) {
+	p, _ := NewInternalProcessor("Gain")
+
+	b.Run("GetParameter", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			p.GetParameter(0)
+		}
+	})
+
+	b.Run("Process/1", func(b *testing.B) {
+		buffer := benchSignal(2, 1)
+		for i := 0; i < b.N; i++ {
+			p.Process(buffer, 44100.0)
+		}
+	})
+
+	b.Run("ProcessContext/1", func(b *testing.B) {
+		ctx, _ := p.NewProcessContext(2, 1)
+		defer ctx.Close()
+		buffer := benchSignal(2, 1)
+		for i := 0; i < b.N; i++ {
+			ctx.Process(buffer, 44100.0)
+		}
+	})
+}
+
+// BenchmarkFileIO measures saving and loading ten seconds of stereo audio.
+func BenchmarkFileIO(b *testing.B) {
+	buffer := &AudioBuffer{Data: benchSignal(2, 441000), SampleRate: 44100}
+	bytes := int64(2 * 441000 * 4)
+
+	for _, ext := range []string{"wav", "aiff", "flac"} {
+		path := filepath.Join(b.TempDir(), "bench."+ext)
+
+		b.Run("Save/"+ext, func(b *testing.B) {
+			b.SetBytes(bytes)
+			for i := 0; i < b.N; i++ {
+				if err := SaveAudioFile(path, buffer); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+
+		b.Run("Load/"+ext, func(b *testing.B) {
+			b.SetBytes(bytes)
+			for i := 0; i < b.N; i++ {
+				if _, err := LoadAudioFile(path); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
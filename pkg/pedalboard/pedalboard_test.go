@@ -1,7 +1,13 @@
 package pedalboard
 
 import (
+	"bytes"
+	"fmt"
+	"math"
+	"os"
+	"sort"
 	"testing"
+	"time"
 )
 
 func TestNewInternalProcessor(t *testing.T) {
@@ -108,6 +114,159 @@ func TestProcess(t *testing.T) {
 	}
 }
 
+func TestBitcrushHold(t *testing.T) {
+	const numSamples, hold = 1000, 7
+	input := make([]float32, numSamples)
+	for i := range input {
+		input[i] = float32(i) / numSamples
+	}
+
+	render := func(splits []int) []float32 {
+		crush, _ := NewInternalProcessor("Bitcrush")
+		crush.SetParameter(0, 0)        // 32 bits: no quantizing, so held values are exact
+		crush.SetParameter(1, 6.5/49.0) // Downsample 7x
+		if err := crush.Prepare(44100.0, 512, 1); err != nil {
+			t.Fatalf("Failed to prepare: %v", err)
+		}
+		output := append([]float32(nil), input...)
+		start := 0
+		for _, end := range append(splits, numSamples) {
+			crush.Process([][]float32{output[start:end]}, 44100.0)
+			start = end
+		}
+		return output
+	}
+
+	// The hold phase carries across calls, so splitting mid-hold changes nothing
+	for _, splits := range [][]int{nil, {3, 10, 11, 250, 600}} {
+		output := render(splits)
+		for i, got := range output {
+			if want := input[i-i%hold]; got != want {
+				t.Errorf("Splits %v, sample %d: expected %f, got %f", splits, i, want, got)
+				break
+			}
+		}
+	}
+}
+
+func TestBitcrushDepth(t *testing.T) {
+	crush, _ := NewInternalProcessor("Bitcrush")
+	crush.SetParameter(0, 7.5/30.0) // 24 bits, past the vectorized rounding's range
+	crush.SetParameter(1, 0)        // No downsampling
+
+	input := []float32{0.1, -0.3, 0.7071}
+	buffer := [][]float32{append([]float32(nil), input...)}
+	crush.Process(buffer, 44100.0)
+	for i, in := range input {
+		want := float32(math.Floor(float64(in)*(1<<23)+0.5) / (1 << 23))
+		if got := buffer[0][i]; got != want {
+			t.Errorf("Sample %d: expected %v quantized to %v, got %v", i, in, want, got)
+		}
+	}
+	if buffer[0][0] == input[0] {
+		t.Error("Expected 24-bit quantizing to change 0.1")
+	}
+}
+
+func TestDelay(t *testing.T) {
+	// 1/64 maps to 31.25 ms, exactly 1500 samples at 48 kHz. The signal runs
+	// past the 2 s delay buffer, so reads and writes wrap around it.
+	const sampleRate, delaySamples, numSamples = 48000.0, 1500, 100000
+	input := benchSignal(1, numSamples)[0]
+
+	render := func(blockSize int, feedback, mix float32) []float32 {
+		delay, _ := NewInternalProcessor("Delay")
+		delay.SetParameter(0, 1.0/64)
+		delay.SetParameter(1, feedback)
+		delay.SetParameter(2, mix)
+		if err := delay.Prepare(sampleRate, blockSize, 1); err != nil {
+			t.Fatalf("Failed to prepare: %v", err)
+		}
+		buffer := [][]float32{append([]float32(nil), input...)}
+		delay.Process(buffer, sampleRate)
+		return buffer[0]
+	}
+
+	// Blocks shorter than the delay take the span path, longer ones the
+	// per-sample path. Wet only, without feedback, both give the input late.
+	for _, blockSize := range []int{256, 2048} {
+		output := render(blockSize, 0, 1)
+		for i, got := range output {
+			var want float32
+			if i >= delaySamples {
+				want = input[i-delaySamples]
+			}
+			if math.Abs(float64(got-want)) > 1e-6 {
+				t.Errorf("Block size %d, sample %d: expected %f, got %f", blockSize, i, want, got)
+				break
+			}
+		}
+	}
+
+	// With feedback and dry signal mixed in, the two paths still agree
+	spans, fixed := render(256, 0.5, 0.5), render(2048, 0.5, 0.5)
+	for i := range spans {
+		if math.Abs(float64(spans[i]-fixed[i])) > 1e-5 {
+			t.Errorf("Sample %d: span path %f, per-sample path %f", i, spans[i], fixed[i])
+			break
+		}
+	}
+}
+
+func TestDistortionModes(t *testing.T) {
+	const sampleRate = 44100.0
+	newDistortion := func(drive, mode float32) *Processor {
+		p, _ := NewInternalProcessor("Distortion")
+		p.SetParameter(0, drive)
+		p.SetParameter(1, mode)
+		if err := p.Prepare(sampleRate, 512, 1); err != nil {
+			t.Fatalf("Failed to prepare: %v", err)
+		}
+		return p
+	}
+
+	// The fast tanh is close enough to std::tanh to stand in for it
+	standard, fast := newDistortion(0.5, 0), newDistortion(0.5, 0.5)
+	a, b := benchSignal(1, 2048), benchSignal(1, 2048)
+	standard.Process(a, sampleRate)
+	fast.Process(b, sampleRate)
+	for i := range a[0] {
+		if diff := math.Abs(float64(a[0][i] - b[0][i])); diff > 1e-3 {
+			t.Fatalf("Sample %d: standard %f, fast %f", i, a[0][i], b[0][i])
+		}
+	}
+	if standard.Latency() != 0 || fast.Latency() != 0 {
+		t.Errorf("Expected no latency without oversampling, got %d and %d", standard.Latency(), fast.Latency())
+	}
+
+	// Oversampling reports its filter delay as soon as the mode is set, and
+	// an impulse comes out exactly that late
+	oversampled := newDistortion(0, 0)
+	oversampled.SetParameter(1, 1)
+	latency := oversampled.Latency()
+	if latency <= 0 {
+		t.Fatalf("Expected oversampling latency, got %d", latency)
+	}
+
+	impulse := [][]float32{make([]float32, 2048)}
+	impulse[0][100] = 0.1
+	oversampled.Process(impulse, sampleRate)
+	peak := 0
+	for i, v := range impulse[0] {
+		if math.Abs(float64(v)) > math.Abs(float64(impulse[0][peak])) {
+			peak = i
+		}
+	}
+	if peak != 100+latency {
+		t.Errorf("Expected the impulse at %d (latency %d), got %d", 100+latency, latency, peak)
+	}
+
+	oversampled.SetParameter(1, 0)
+	if got := oversampled.Latency(); got != 0 {
+		t.Errorf("Expected latency 0 after leaving oversampled mode, got %d", got)
+	}
+}
+
 func TestAudioStreamCreation(t *testing.T) {
 	// We might not be able to start/stop the stream in a CI environment without audio hardware,
 	// but we can at least test creation and closing.
@@ -171,3 +330,976 @@ func TestFileIO(t *testing.T) {
 		}
 	}
 }
+
+func TestChain(t *testing.T) {
+	gain1, _ := NewInternalProcessor("Gain")
+	gain1.SetParameter(0, 0.5)
+	gain2, _ := NewInternalProcessor("Gain")
+	gain2.SetParameter(0, 0.5)
+
+	chain, err := NewChain(gain1, gain2)
+	if err != nil {
+		t.Fatalf("Failed to create chain: %v", err)
+	}
+	if chain.Len() != 2 {
+		t.Fatalf("Expected 2 processors in chain, got %d", chain.Len())
+	}
+
+	buffer := [][]float32{make([]float32, 100), make([]float32, 100)}
+	for c := range buffer {
+		for i := range buffer[c] {
+			buffer[c][i] = 1.0
+		}
+	}
+
+	chain.Process(buffer, 44100.0)
+
+	// Both gains applied: 1.0 * 0.5 * 0.5 = 0.25
+	for c := range buffer {
+		if buffer[c][99] != 0.25 {
+			t.Errorf("Channel %d: expected 0.25, got %f", c, buffer[c][99])
+		}
+	}
+
+	if err := chain.Remove(0); err != nil {
+		t.Fatalf("Failed to remove processor: %v", err)
+	}
+	if err := chain.Remove(5); err == nil {
+		t.Error("Expected error removing out-of-range index")
+	}
+	if chain.Len() != 1 {
+		t.Errorf("Expected 1 processor in chain, got %d", chain.Len())
+	}
+}
+
+func TestStreamingFileIO(t *testing.T) {
+	tmpFile := t.TempDir() + "/test_stream.wav"
+
+	writer, err := CreateAudioWriter(tmpFile, 44100.0, 2, 16)
+	if err != nil {
+		t.Fatalf("Failed to create writer: %v", err)
+	}
+	chunk := [][]float32{make([]float32, 64), make([]float32, 64)}
+	for n := 0; n < 4; n++ {
+		for c := range chunk {
+			for i := range chunk[c] {
+				chunk[c][i] = float32(n+1) * 0.1
+			}
+		}
+		if err := writer.Write(chunk); err != nil {
+			t.Fatalf("Failed to write chunk %d: %v", n, err)
+		}
+	}
+	writer.Close()
+
+	reader, err := OpenAudioReader(tmpFile)
+	if err != nil {
+		t.Fatalf("Failed to open reader: %v", err)
+	}
+	defer reader.Close()
+
+	if reader.NumChannels != 2 || reader.NumSamples != 256 {
+		t.Fatalf("Expected 2 channels and 256 samples, got %d and %d", reader.NumChannels, reader.NumSamples)
+	}
+
+	if err := reader.SeekTo(192); err != nil {
+		t.Fatalf("Failed to seek: %v", err)
+	}
+	n, err := reader.Read(chunk)
+	if err != nil || n != 64 {
+		t.Fatalf("Expected 64 samples, got %d (%v)", n, err)
+	}
+	if diff := chunk[0][0] - 0.4; diff > 0.01 || diff < -0.01 {
+		t.Errorf("Expected sample near 0.4 after seek, got %f", chunk[0][0])
+	}
+	if _, err := reader.Read(chunk); err == nil {
+		t.Error("Expected EOF at end of file")
+	}
+}
+
+func TestNativeAudioBuffer(t *testing.T) {
+	buffer, err := NewNativeAudioBuffer(2, 128, 44100.0)
+	if err != nil {
+		t.Fatalf("Failed to allocate native buffer: %v", err)
+	}
+	defer buffer.Free()
+
+	for c := range buffer.Data {
+		for i := range buffer.Data[c] {
+			buffer.Data[c][i] = 0.5
+		}
+	}
+
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+	gain.ProcessNative(buffer)
+
+	if buffer.Data[1][127] != 0.25 {
+		t.Errorf("Expected 0.25 after gain, got %f", buffer.Data[1][127])
+	}
+
+	tmpFile := t.TempDir() + "/test_native.wav"
+	if err := SaveNativeAudioFile(tmpFile, buffer); err != nil {
+		t.Fatalf("Failed to save native buffer: %v", err)
+	}
+
+	loaded, err := LoadNativeAudioFile(tmpFile)
+	if err != nil {
+		t.Fatalf("Failed to load native buffer: %v", err)
+	}
+	defer loaded.Free()
+
+	if loaded.NumChannels() != 2 || loaded.NumSamples() != 128 {
+		t.Fatalf("Expected 2 x 128, got %d x %d", loaded.NumChannels(), loaded.NumSamples())
+	}
+	if diff := loaded.Data[0][64] - 0.25; diff > 0.01 || diff < -0.01 {
+		t.Errorf("Expected sample near 0.25, got %f", loaded.Data[0][64])
+	}
+}
+
+func TestProcessContext(t *testing.T) {
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+
+	ctx, err := gain.NewProcessContext(2, 64)
+	if err != nil {
+		t.Fatalf("Failed to create process context: %v", err)
+	}
+	defer ctx.Close()
+
+	// Planar Go buffer through the pinned pointer table
+	buffer := [][]float32{make([]float32, 64), make([]float32, 64)}
+	for c := range buffer {
+		for i := range buffer[c] {
+			buffer[c][i] = 1.0
+		}
+	}
+	ctx.Process(buffer, 44100.0)
+	if buffer[0][0] != 0.5 || buffer[1][63] != 0.5 {
+		t.Errorf("Expected 0.5 after planar process, got %f and %f", buffer[0][0], buffer[1][63])
+	}
+
+	// Interleaved frames, longer than the context's block size
+	interleaved := make([]float32, 2*100)
+	for i := range interleaved {
+		interleaved[i] = 1.0
+	}
+	ctx.ProcessInterleaved(interleaved, 44100.0)
+	if interleaved[0] != 0.5 || interleaved[199] != 0.5 {
+		t.Errorf("Expected 0.5 after interleaved process, got %f and %f", interleaved[0], interleaved[199])
+	}
+
+	// The context's own buffer must not allocate at steady state
+	allocs := testing.AllocsPerRun(100, func() {
+		ctx.ProcessData(64, 44100.0)
+	})
+	if allocs != 0 {
+		t.Errorf("Expected 0 allocations per ProcessData, got %f", allocs)
+	}
+}
+
+func TestRenderBatch(t *testing.T) {
+	tmpDir := t.TempDir()
+	source := &AudioBuffer{
+		Data:       [][]float32{make([]float32, 1000), make([]float32, 1000)},
+		SampleRate: 44100.0,
+	}
+	for c := range source.Data {
+		for i := range source.Data[c] {
+			source.Data[c][i] = 0.5
+		}
+	}
+
+	var jobs []RenderJob
+	for i := 0; i < 4; i++ {
+		input := fmt.Sprintf("%s/in%d.wav", tmpDir, i)
+		if err := SaveAudioFile(input, source); err != nil {
+			t.Fatalf("Failed to save input: %v", err)
+		}
+		jobs = append(jobs, RenderJob{Input: input, Output: fmt.Sprintf("%s/out%d.wav", tmpDir, i)})
+	}
+	jobs = append(jobs, RenderJob{Input: tmpDir + "/missing.wav", Output: tmpDir + "/missing_out.wav"})
+
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+	chain, _ := NewChain(gain)
+
+	results, err := chain.RenderBatch(jobs, 2)
+	if err == nil {
+		t.Error("Expected an error for the missing input")
+	}
+	for i := 0; i < 4; i++ {
+		if !results[i] {
+			t.Fatalf("Job %d failed", i)
+		}
+		loaded, err := LoadAudioFile(jobs[i].Output)
+		if err != nil {
+			t.Fatalf("Failed to load output %d: %v", i, err)
+		}
+		if diff := loaded.Data[0][500] - 0.25; diff > 0.01 || diff < -0.01 {
+			t.Errorf("Job %d: expected sample near 0.25, got %f", i, loaded.Data[0][500])
+		}
+	}
+	if results[4] {
+		t.Error("Expected the missing input job to fail")
+	}
+
+	// A graph can't be copied for the workers, so no job runs
+	graph, _ := NewGraph()
+	graphChain, _ := NewChain(graph.AsProcessor())
+	results, err = graphChain.RenderBatch(jobs[:4], 2)
+	if err == nil {
+		t.Error("Expected an error rendering a chain that can't be copied")
+	}
+	for i, ok := range results {
+		if ok {
+			t.Errorf("Job %d: expected failure when the chain can't be copied", i)
+		}
+	}
+}
+
+func TestRenderCache(t *testing.T) {
+	tmpDir := t.TempDir()
+	source := &AudioBuffer{Data: benchSignal(2, 1000), SampleRate: 44100.0}
+	input := tmpDir + "/in.wav"
+	if err := SaveAudioFile(input, source); err != nil {
+		t.Fatalf("Failed to save input: %v", err)
+	}
+
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+	chain, _ := NewChain(gain)
+	cache, err := NewRenderCache(1<<20, tmpDir+"/cache")
+	if err != nil {
+		t.Fatalf("Failed to create cache: %v", err)
+	}
+	defer cache.Close()
+
+	render := func(c *RenderCache, output string) {
+		if _, err := chain.RenderBatchCached([]RenderJob{{Input: input, Output: tmpDir + "/" + output}}, 1, c); err != nil {
+			t.Fatalf("Render %s failed: %v", output, err)
+		}
+	}
+	expect := func(c *RenderCache, hits, misses int64) {
+		if stats := c.Stats(); stats.Hits != hits || stats.Misses != misses {
+			t.Fatalf("Expected %d hits and %d misses, got %+v", hits, misses, stats)
+		}
+	}
+
+	render(cache, "first.wav")
+	render(cache, "second.wav")
+	expect(cache, 1, 1)
+	first, _ := os.ReadFile(tmpDir + "/first.wav")
+	second, _ := os.ReadFile(tmpDir + "/second.wav")
+	if len(first) == 0 || !bytes.Equal(first, second) {
+		t.Fatal("Cached render differs from the original")
+	}
+
+	// Any parameter change is a different render
+	gain.SetParameter(0, 0.25)
+	render(cache, "third.wav")
+	expect(cache, 1, 2)
+
+	// A new cache over the same directory finds earlier renders on disk
+	reopened, _ := NewRenderCache(0, tmpDir+"/cache")
+	defer reopened.Close()
+	render(reopened, "fourth.wav")
+	expect(reopened, 1, 0)
+}
+
+func TestProcessorPool(t *testing.T) {
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+
+	clone, err := gain.Clone()
+	if err != nil {
+		t.Fatalf("Failed to clone processor: %v", err)
+	}
+	if clone.GetParameter(0) != 0.5 {
+		t.Errorf("Expected cloned parameter 0.5, got %f", clone.GetParameter(0))
+	}
+
+	pool, err := NewProcessorPool(gain, 2, 44100.0, 512)
+	if err != nil {
+		t.Fatalf("Failed to create pool: %v", err)
+	}
+	defer pool.Close()
+
+	if pool.Available() != 2 {
+		t.Fatalf("Expected 2 idle processors, got %d", pool.Available())
+	}
+
+	p, err := pool.Acquire()
+	if err != nil {
+		t.Fatalf("Failed to acquire processor: %v", err)
+	}
+	if pool.Available() != 1 {
+		t.Errorf("Expected 1 idle processor, got %d", pool.Available())
+	}
+
+	// Changes made while borrowed don't survive a release
+	p.SetParameter(0, 0.1)
+	pool.Release(p)
+
+	p, _ = pool.Acquire()
+	if p.GetParameter(0) != 0.5 {
+		t.Errorf("Expected parameter reset to 0.5, got %f", p.GetParameter(0))
+	}
+	pool.Release(p)
+}
+
+func TestPrepareSplitsLargeBlocks(t *testing.T) {
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+	if err := gain.Prepare(44100.0, 128, 2); err != nil {
+		t.Fatalf("Failed to prepare: %v", err)
+	}
+
+	// Not a multiple of the block size, so the last block is partial
+	buffer := [][]float32{make([]float32, 1000), make([]float32, 1000)}
+	for c := range buffer {
+		for i := range buffer[c] {
+			buffer[c][i] = 1.0
+		}
+	}
+	gain.Process(buffer, 44100.0)
+
+	for c := range buffer {
+		for _, i := range []int{0, 127, 128, 999} {
+			if buffer[c][i] != 0.5 {
+				t.Errorf("Channel %d sample %d: expected 0.5, got %f", c, i, buffer[c][i])
+			}
+		}
+	}
+
+	if err := gain.Prepare(0, 128, 2); err == nil {
+		t.Error("Expected error preparing with an invalid sample rate")
+	}
+}
+
+func TestGraph(t *testing.T) {
+	graph, err := NewGraph()
+	if err != nil {
+		t.Fatalf("Failed to create graph: %v", err)
+	}
+	graph.SetNumThreads(2)
+
+	// Dry/wet split: input -> gain -> output, plus input -> mix -> output
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+	wet, err := graph.AddProcessor(gain)
+	if err != nil {
+		t.Fatalf("Failed to add processor: %v", err)
+	}
+	dry, _ := graph.AddMix(0.25)
+
+	for _, c := range [][2]int{{GraphInput, wet}, {wet, GraphOutput}, {GraphInput, dry}, {dry, GraphOutput}} {
+		if err := graph.Connect(c[0], 0, c[1]); err != nil {
+			t.Fatalf("Failed to connect: %v", err)
+		}
+	}
+	if err := graph.Connect(GraphOutput, 0, wet); err == nil {
+		t.Error("Expected error connecting from the output node")
+	}
+	if err := graph.Connect(wet, 0, wet); err == nil {
+		t.Error("Expected error creating a cycle")
+	}
+
+	buffer := [][]float32{make([]float32, 256), make([]float32, 256)}
+	for c := range buffer {
+		for i := range buffer[c] {
+			buffer[c][i] = 1.0
+		}
+	}
+	graph.Process(buffer, 44100.0)
+
+	// 1.0 * 0.5 + 1.0 * 0.25
+	for c := range buffer {
+		if buffer[c][255] != 0.75 {
+			t.Errorf("Channel %d: expected 0.75, got %f", c, buffer[c][255])
+		}
+	}
+	if graph.Latency() != 0 {
+		t.Errorf("Expected no latency, got %d", graph.Latency())
+	}
+
+	// A latency change inside the graph is compensated before the next block
+	drive, _ := NewInternalProcessor("Distortion")
+	shaped, _ := graph.AddProcessor(drive)
+	graph.Connect(GraphInput, 0, shaped)
+	graph.Connect(shaped, 0, GraphOutput)
+	drive.SetParameter(1, 1) // Oversampled
+	if graph.Latency() == 0 || graph.Latency() != drive.Latency() {
+		t.Errorf("Expected graph latency %d from the oversampled branch, got %d", drive.Latency(), graph.Latency())
+	}
+	graph.Process(buffer, 44100.0)
+}
+
+func TestStreamInfoLatency(t *testing.T) {
+	if _, err := GetOutputDevices(); err != nil {
+		t.Errorf("Failed to list output devices: %v", err)
+	}
+
+	info := StreamInfo{SampleRate: 48000, BufferSize: 64, InputLatency: 32, OutputLatency: 32, ProcessorLatency: 16}
+	if got := info.RoundTripLatency(); got != 3*time.Millisecond {
+		t.Errorf("Expected 3ms round trip, got %v", got)
+	}
+}
+
+func TestProcessorStats(t *testing.T) {
+	gain, _ := NewInternalProcessor("Gain")
+	chain, _ := NewChain(gain)
+
+	buffer := [][]float32{make([]float32, 256), make([]float32, 256)}
+	chain.Process(buffer, 44100.0)
+	chain.Process(buffer, 44100.0)
+
+	// Time is recorded for processors inside a chain too
+	if calls := gain.Stats().Calls; calls != 2 {
+		t.Errorf("Expected 2 calls, got %d", calls)
+	}
+	if calls := chain.AsProcessor().Stats().Calls; calls != 2 {
+		t.Errorf("Expected 2 chain calls, got %d", calls)
+	}
+
+	gain.ResetStats()
+	if stats := gain.Stats(); stats.Calls != 0 || stats.Mean() != 0 {
+		t.Errorf("Expected cleared stats, got %+v", stats)
+	}
+}
+
+func TestAutoBypass(t *testing.T) {
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 1.0) // Unity; juce::dsp::Gain starts silent
+	delay, _ := NewInternalProcessor("Delay")
+	delay.SetParameter(0, 0.025) // 50 ms
+	delay.SetParameter(1, 0.0)   // No feedback, so the tail is one echo
+	chain, _ := NewChain(gain, delay)
+	chain.SetAutoBypass(true)
+
+	buffer := [][]float32{make([]float32, 512)}
+	buffer[0][0] = 1.0
+	chain.Process(buffer, 44100.0)
+
+	// The echo arrives 2205 samples later, in the fifth block, so the delay
+	// must keep running on silent input until then
+	var echo float32
+	for n := 0; n < 10; n++ {
+		buffer[0] = make([]float32, 512)
+		chain.Process(buffer, 44100.0)
+		for _, v := range buffer[0] {
+			if v > echo {
+				echo = v
+			}
+		}
+	}
+	if echo < 0.4 {
+		t.Errorf("Expected the delay's echo while bypassing, got peak %f", echo)
+	}
+
+	if stats := gain.Stats(); stats.Calls != 1 || stats.Bypassed != 10 {
+		t.Errorf("Expected gain to run once and be bypassed 10 times, got %+v", stats)
+	}
+	if stats := delay.Stats(); stats.Bypassed == 0 || stats.Calls+stats.Bypassed != 11 {
+		t.Errorf("Expected the delay to be bypassed after its tail, got %+v", stats)
+	}
+
+	// Signal resumes processing immediately
+	buffer[0][0] = 1.0
+	chain.Process(buffer, 44100.0)
+	if calls := gain.Stats().Calls; calls != 2 {
+		t.Errorf("Expected gain to resume, got %d calls", calls)
+	}
+}
+
+func TestWideChannelCounts(t *testing.T) {
+	const numChannels, numSamples = 16, 512
+	for _, name := range []string{"LowPass", "Reverb"} {
+		wide, _ := NewInternalProcessor(name)
+		mono, _ := NewInternalProcessor(name)
+
+		buffer := make([][]float32, numChannels)
+		for c := range buffer {
+			buffer[c] = make([]float32, numSamples)
+		}
+		buffer[5][0] = 1.0
+		reference := [][]float32{make([]float32, numSamples)}
+		reference[0][0] = 1.0
+
+		wide.Process(buffer, 44100.0)
+		mono.Process(reference, 44100.0)
+
+		// Every channel is an independent track matching a mono instance
+		for c := range buffer {
+			for i, v := range buffer[c] {
+				expected := float32(0)
+				if c == 5 {
+					expected = reference[0][i]
+				}
+				if diff := v - expected; diff > 1e-5 || diff < -1e-5 {
+					t.Fatalf("%s: channel %d sample %d: expected %f, got %f", name, c, i, expected, v)
+				}
+			}
+		}
+	}
+}
+
+func TestFusedChain(t *testing.T) {
+	if _, err := NewFusedChain("Bitcrush", "Gain"); err == nil {
+		t.Error("Expected an error for a sequence with no preset")
+	}
+	if len(FusedChainPresets()) == 0 {
+		t.Fatal("Expected fused chain presets")
+	}
+
+	fused, err := NewFusedChain("Gain", "Limiter")
+	if err != nil {
+		t.Fatalf("Failed to create fused chain: %v", err)
+	}
+	gain, _ := NewInternalProcessor("Gain")
+	limiter, _ := NewInternalProcessor("Limiter")
+	chain, _ := NewChain(gain, limiter)
+
+	// Parameters are indexed across stages: Gain has one, so the limiter's threshold is 1
+	if n := fused.NumParameters(); n != 3 {
+		t.Errorf("Expected 3 parameters, got %d", n)
+	}
+	fused.SetParameter(0, 0.5)
+	fused.SetParameter(1, 0.2)
+	gain.SetParameter(0, 0.5)
+	limiter.SetParameter(0, 0.2)
+	if v := fused.GetParameter(1); v != 0.2 {
+		t.Errorf("Expected limiter threshold 0.2, got %f", v)
+	}
+
+	a := [][]float32{make([]float32, 512), make([]float32, 512)}
+	b := [][]float32{make([]float32, 512), make([]float32, 512)}
+	for c := range a {
+		for i := range a[c] {
+			a[c][i] = float32(i%64)/32.0 - 1.0
+			b[c][i] = a[c][i]
+		}
+	}
+	fused.Process(a, 44100.0)
+	chain.Process(b, 44100.0)
+	for c := range a {
+		for i := range a[c] {
+			if a[c][i] != b[c][i] {
+				t.Fatalf("Fused output differs from chain at %d/%d: %f vs %f", c, i, a[c][i], b[c][i])
+			}
+		}
+	}
+}
+
+func TestProcessAutomated(t *testing.T) {
+	clip, _ := NewInternalProcessor("Clipping")
+	events := []ParameterEvent{
+		{Offset: 100, Index: 0, Value: 0.0}, // Clip at 0.1
+		{Offset: 700, Index: 0, Value: 1.0}, // No clipping
+	}
+
+	check := func(name string, buffer [][]float32) {
+		for i, v := range buffer[0] {
+			expected := float32(0.5)
+			if i >= 100 && i < 700 {
+				expected = 0.1
+			}
+			if diff := v - expected; diff > 1e-6 || diff < -1e-6 {
+				t.Fatalf("%s: sample %d: expected %f, got %f", name, i, expected, v)
+			}
+		}
+	}
+	signal := func() [][]float32 {
+		buffer := [][]float32{make([]float32, 1024)}
+		for i := range buffer[0] {
+			buffer[0][i] = 0.5
+		}
+		return buffer
+	}
+
+	buffer := signal()
+	clip.ProcessAutomated(buffer, 44100.0, events)
+	check("Processor", buffer)
+
+	ctx, err := clip.NewProcessContext(1, 1024)
+	if err != nil {
+		t.Fatalf("Failed to create context: %v", err)
+	}
+	defer ctx.Close()
+	buffer = signal()
+	ctx.ProcessAutomated(buffer, 44100.0, events)
+	check("ProcessContext", buffer)
+}
+
+func TestConvolution(t *testing.T) {
+	conv, err := NewInternalProcessor("Convolution")
+	if err != nil {
+		t.Fatalf("Failed to create Convolution: %v", err)
+	}
+	const headSize = 256
+	if err := conv.Prepare(44100.0, headSize, 1); err != nil {
+		t.Fatalf("Failed to prepare: %v", err)
+	}
+
+	// Long enough to span several partition sizes
+	ir := [][]float32{make([]float32, 5000)}
+	seed := uint32(1)
+	for i := range ir[0] {
+		seed = seed*1664525 + 1013904223
+		ir[0][i] = (float32(seed>>8)/16777216.0 - 0.5) / float32(1+i/500)
+	}
+	if err := conv.SetImpulseResponse(ir, 44100.0); err != nil {
+		t.Fatalf("Failed to set impulse response: %v", err)
+	}
+	clone, err := conv.Clone()
+	if err != nil {
+		t.Fatalf("Failed to clone: %v", err)
+	}
+
+	// An impulse comes back as the IR, delayed by the head size
+	for name, p := range map[string]*Processor{"Processor": conv, "Clone": clone} {
+		buffer := [][]float32{make([]float32, 8192)}
+		buffer[0][0] = 1.0
+		p.Process(buffer, 44100.0)
+		for i, v := range buffer[0] {
+			expected := float32(0.0)
+			if k := i - headSize; k >= 0 && k < len(ir[0]) {
+				expected = ir[0][k]
+			}
+			if diff := v - expected; diff > 1e-4 || diff < -1e-4 {
+				t.Fatalf("%s: sample %d: expected %f, got %f", name, i, expected, v)
+			}
+		}
+	}
+}
+
+func TestConvolutionBlockCost(t *testing.T) {
+	const sampleRate, blockSize, period = 48000.0, 128, 16384
+	conv, _ := NewInternalProcessor("Convolution")
+	if err := conv.Prepare(sampleRate, blockSize, 2); err != nil {
+		t.Fatalf("Failed to prepare: %v", err)
+	}
+	// 4 s, so most of the work is in the longest partitions
+	if err := conv.SetImpulseResponse(benchSignal(2, 4*sampleRate), sampleRate); err != nil {
+		t.Fatalf("Failed to set impulse response: %v", err)
+	}
+	ctx, err := conv.NewProcessContext(2, blockSize)
+	if err != nil {
+		t.Fatalf("Failed to create context: %v", err)
+	}
+	defer ctx.Close()
+
+	// Two periods of the longest partitions to fill the pipeline, then ten measured
+	buffer := benchSignal(2, blockSize)
+	const warmup, measured = 2 * period / blockSize, 10 * period / blockSize
+	times := make([]time.Duration, 0, measured)
+	var total time.Duration
+	for n := 0; n < warmup+measured; n++ {
+		start := time.Now()
+		ctx.Process(buffer, sampleRate)
+		if elapsed := time.Since(start); n >= warmup {
+			times = append(times, elapsed)
+			total += elapsed
+		}
+	}
+
+	// Finishing whole partitions in the block that fills them would make
+	// one block each period cost about as much as the period. With the work
+	// spread out, no block comes close. The three slowest are ignored as
+	// scheduling noise.
+	sort.Slice(times, func(i, j int) bool { return times[i] > times[j] })
+	if perPeriod := total / 10; times[3] > perPeriod/4 {
+		t.Errorf("Expected no block to cost more than a quarter of a period's %v, got %v", perPeriod, times[3])
+	}
+}
+
+func TestAnalyzer(t *testing.T) {
+	const sampleRate, fftSize = 48000.0, 2048
+	analyzer, err := NewAnalyzer(sampleRate, 2, fftSize)
+	if err != nil {
+		t.Fatalf("Failed to create analyzer: %v", err)
+	}
+	defer analyzer.Close()
+
+	// A 997 Hz sine at -6 dBFS in both channels measures -6 LUFS
+	signal := [][]float32{make([]float32, 5*sampleRate), make([]float32, 5*sampleRate)}
+	for i := range signal[0] {
+		v := float32(0.5 * math.Sin(2*math.Pi*997*float64(i)/sampleRate))
+		signal[0][i], signal[1][i] = v, v
+	}
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetAnalyzer(analyzer)
+	gain.Process([][]float32{signal[0][:1000], signal[1][:1000]}, sampleRate)
+	if n := analyzer.Results().Samples; n != 1000 {
+		t.Fatalf("Expected the attached analyzer to see 1000 samples, got %d", n)
+	}
+	gain.SetAnalyzer(nil)
+
+	analyzer.Reset()
+	analyzer.Process(signal)
+	r := analyzer.Results()
+	near := func(name string, got, expected, tolerance float32) {
+		if got < expected-tolerance || got > expected+tolerance {
+			t.Errorf("%s: expected %f, got %f", name, expected, got)
+		}
+	}
+	near("Peak", r.Peak, 0.5, 0.001)
+	near("TruePeak", r.TruePeak, 0.5, 0.01)
+	near("RMS", r.RMS, 0.3536, 0.001)
+	near("IntegratedLUFS", r.IntegratedLUFS, -6.02, 0.1)
+	near("ShortTermLUFS", r.ShortTermLUFS, -6.02, 0.1)
+
+	spectrum := analyzer.Spectrum()
+	if len(spectrum) != fftSize/2+1 {
+		t.Fatalf("Expected %d bins, got %d", fftSize/2+1, len(spectrum))
+	}
+	loudest := 0
+	for bin, v := range spectrum {
+		if v > spectrum[loudest] {
+			loudest = bin
+		}
+	}
+	// 997 Hz falls between bins, so allow for the window's scalloping loss
+	if expected := 997 * fftSize / sampleRate; math.Abs(float64(loudest)-expected) > 1 {
+		t.Errorf("Expected the loudest bin near %f, got %d", expected, loudest)
+	}
+	near("Spectrum peak", spectrum[loudest], -6.02, 2)
+
+	// Fewer channels than the analyzer has measure only those passed
+	analyzer.Reset()
+	analyzer.Process(signal[:1])
+	r = analyzer.Results()
+	near("Mono RMS", r.RMS, 0.3536, 0.001)
+	near("Mono TruePeak", r.TruePeak, 0.5, 0.01)
+
+	// At fs/4 with a 45 degree phase every sample misses the peak, which
+	// falls halfway between two of them
+	for i := range signal[0] {
+		signal[0][i] = float32(0.5 * math.Sin(math.Pi/2*float64(i)+math.Pi/4))
+	}
+	analyzer.Reset()
+	analyzer.Process(signal[:1])
+	r = analyzer.Results()
+	near("Inter-sample Peak", r.Peak, 0.3536, 0.001)
+	near("Inter-sample TruePeak", r.TruePeak, 0.5, 0.01)
+}
+
+func TestAudioTap(t *testing.T) {
+	tap, err := NewAudioTap(2, 1500)
+	if err != nil {
+		t.Fatalf("Failed to create tap: %v", err)
+	}
+	defer tap.Close()
+
+	gain, _ := NewInternalProcessor("Gain")
+	chain, _ := NewChain(gain)
+	gain.SetTap(tap)
+
+	// Two 1000-sample blocks into a 1500-sample ring: the excess is dropped
+	for i := 0; i < 2; i++ {
+		chain.Process(benchSignal(2, 1000), 44100.0)
+	}
+	if available, dropped := tap.Available(), tap.Dropped(); available != 1500 || dropped != 500 {
+		t.Fatalf("Expected 1500 available and 500 dropped, got %d and %d", available, dropped)
+	}
+
+	out := [][]float32{make([]float32, 1000), make([]float32, 1000)}
+	if n := tap.Read(out); n != 1000 {
+		t.Fatalf("Expected to read 1000 samples, got %d", n)
+	}
+	expected := benchSignal(2, 1000)
+	gain.Process(expected, 44100.0)
+	for i := range out[1] {
+		if out[1][i] != expected[1][i] {
+			t.Fatalf("Sample %d: expected %f, got %f", i, expected[1][i], out[1][i])
+		}
+	}
+	if n := tap.Read(out); n != 500 {
+		t.Fatalf("Expected the remaining 500 samples, got %d", n)
+	}
+	gain.SetTap(nil)
+}
+
+func TestCompactAudioBuffer(t *testing.T) {
+	source := &AudioBuffer{Data: benchSignal(2, 10000), SampleRate: 44100.0}
+	clip, _ := NewInternalProcessor("Clipping")
+	expected := &AudioBuffer{Data: benchSignal(2, 10000), SampleRate: 44100.0}
+	clip.Process(expected.Data, expected.SampleRate)
+
+	// Each sample is rounded twice, on the way in and after processing. The
+	// signal peaks at 0.25, where float16 steps are 1/8192.
+	for format, tolerance := range map[SampleFormat]float64{SampleInt16: 2.0 / 32768, SampleFloat16: 2.0 / 8192} {
+		compact, err := NewCompactAudioBufferFrom(source, format)
+		if err != nil {
+			t.Fatalf("Format %d: %v", format, err)
+		}
+		if compact.Format() != format || compact.NumChannels() != 2 || compact.NumSamples() != 10000 {
+			t.Fatalf("Format %d: unexpected layout", format)
+		}
+
+		clip.ProcessCompact(compact)
+		decoded, err := compact.ToAudioBuffer()
+		if err != nil {
+			t.Fatalf("Format %d: %v", format, err)
+		}
+		compact.Free()
+
+		for c := range decoded.Data {
+			for i, v := range decoded.Data[c] {
+				want := float64(expected.Data[c][i])
+				if math.Abs(float64(v)-want) > tolerance {
+					t.Fatalf("Format %d: channel %d sample %d: expected %f, got %f", format, c, i, want, v)
+				}
+			}
+		}
+	}
+}
+
+func TestMappedAudioReader(t *testing.T) {
+	tmpFile := t.TempDir() + "/test_mapped.wav"
+
+	writer, err := CreateAudioWriter(tmpFile, 44100.0, 2, 16)
+	if err != nil {
+		t.Fatalf("Failed to create writer: %v", err)
+	}
+	chunk := [][]float32{make([]float32, 128), make([]float32, 128)}
+	for n := 0; n < 2; n++ {
+		for c := range chunk {
+			for i := range chunk[c] {
+				chunk[c][i] = float32(n+1) * 0.25
+			}
+		}
+		writer.Write(chunk)
+	}
+	writer.Close()
+
+	reader, err := OpenMappedAudioReader(tmpFile)
+	if err != nil {
+		t.Fatalf("Failed to open mapped reader: %v", err)
+	}
+	defer reader.Close()
+
+	if !reader.Mapped() {
+		t.Error("Expected WAV file to be memory mapped")
+	}
+	if err := reader.SeekTo(128); err != nil {
+		t.Fatalf("Failed to seek: %v", err)
+	}
+	n, err := reader.Read(chunk)
+	if err != nil || n != 128 {
+		t.Fatalf("Expected 128 samples, got %d (%v)", n, err)
+	}
+	if diff := chunk[1][0] - 0.5; diff > 0.01 || diff < -0.01 {
+		t.Errorf("Expected sample near 0.5 after seek, got %f", chunk[1][0])
+	}
+}
+
+func TestThreadedWriterOptions(t *testing.T) {
+	tmpFile := t.TempDir() + "/test_threaded.wav"
+
+	writer, err := CreateAudioWriterWithOptions(tmpFile, 48000.0, 2, WriterOptions{BitsPerSample: 24, Threaded: true, BufferSamples: 256})
+	if err != nil {
+		t.Fatalf("Failed to create threaded writer: %v", err)
+	}
+	// Larger than the FIFO, so the write is queued in chunks
+	chunk := [][]float32{make([]float32, 1000), make([]float32, 1000)}
+	for c := range chunk {
+		for i := range chunk[c] {
+			chunk[c][i] = 0.5
+		}
+	}
+	if err := writer.Write(chunk); err != nil {
+		t.Fatalf("Failed to write: %v", err)
+	}
+	if err := writer.Close(); err != nil {
+		t.Fatalf("Failed to close: %v", err)
+	}
+
+	reader, err := OpenAudioReader(tmpFile)
+	if err != nil {
+		t.Fatalf("Failed to open reader: %v", err)
+	}
+	defer reader.Close()
+	if reader.NumSamples != 1000 || reader.BitsPerSample != 24 {
+		t.Errorf("Expected 1000 24-bit samples, got %d at %d bits", reader.NumSamples, reader.BitsPerSample)
+	}
+
+	if _, err := CreateAudioWriterWithOptions(tmpFile, 48000.0, 2, WriterOptions{BitsPerSample: 7}); err == nil {
+		t.Error("Expected error for unsupported bit depth")
+	}
+
+	// The encoder rejects this rate only once the file is open; the
+	// existing file must survive that
+	flacFile := t.TempDir() + "/test_existing.flac"
+	if err := SaveAudioFile(flacFile, &AudioBuffer{Data: chunk, SampleRate: 48000}); err != nil {
+		t.Fatalf("Failed to save: %v", err)
+	}
+	if _, err := CreateAudioWriter(flacFile, 2000000.0, 2, 16); err == nil {
+		t.Error("Expected error for a rate FLAC can't store")
+	}
+	if existing, err := LoadAudioFile(flacFile); err != nil || len(existing.Data[0]) != 1000 {
+		t.Errorf("Expected the existing file to be kept, got %v", err)
+	}
+
+	// Closing moves the file into place, which a directory in the way blocks
+	blocked := t.TempDir() + "/blocked.wav"
+	os.MkdirAll(blocked+"/inside", 0o755)
+	writer, err = CreateAudioWriter(blocked, 48000.0, 2, 16)
+	if err != nil {
+		t.Fatalf("Failed to create writer: %v", err)
+	}
+	writer.Write(chunk)
+	if err := writer.Close(); err == nil {
+		t.Error("Expected an error closing a writer whose target is a directory")
+	}
+}
+
+func TestResampling(t *testing.T) {
+	gain, _ := NewInternalProcessor("Gain")
+	gain.SetParameter(0, 0.5)
+	resampled, err := NewResampledProcessor(gain, 48000.0)
+	if err != nil {
+		t.Fatalf("Failed to create resampled processor: %v", err)
+	}
+
+	// The inner gain runs at 48kHz whichever rate the wrapper is called at
+	for _, rate := range []float64{44100.0, 96000.0} {
+		buffer := [][]float32{make([]float32, 4096), make([]float32, 4096)}
+		for c := range buffer {
+			for i := range buffer[c] {
+				buffer[c][i] = 1.0
+			}
+		}
+		resampled.Process(buffer, rate)
+		if diff := buffer[0][4095] - 0.5; diff > 0.02 || diff < -0.02 {
+			t.Errorf("At %g Hz: expected settled output near 0.5, got %f", rate, buffer[0][4095])
+		}
+	}
+
+	tmpFile := t.TempDir() + "/test_resample.wav"
+	constant := &AudioBuffer{Data: [][]float32{make([]float32, 1000)}, SampleRate: 44100}
+	for i := range constant.Data[0] {
+		constant.Data[0][i] = 0.5
+	}
+	if err := SaveAudioFile(tmpFile, constant); err != nil {
+		t.Fatalf("Failed to save: %v", err)
+	}
+
+	reader, err := OpenResampledAudioReader(tmpFile, 48000.0)
+	if err != nil {
+		t.Fatalf("Failed to open resampled reader: %v", err)
+	}
+	defer reader.Close()
+	if reader.SampleRate != 48000.0 || reader.NumSamples != 1089 {
+		t.Fatalf("Expected 1089 samples at 48kHz, got %d at %g", reader.NumSamples, reader.SampleRate)
+	}
+
+	chunk := [][]float32{make([]float32, 2000)}
+	n, _ := reader.Read(chunk)
+	if n != 1089 {
+		t.Errorf("Expected to read 1089 samples, got %d", n)
+	}
+	if diff := chunk[0][500] - 0.5; diff > 0.02 || diff < -0.02 {
+		t.Errorf("Expected converted sample near 0.5, got %f", chunk[0][500])
+	}
+}